@@ -0,0 +1,149 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "assets.h"
+
+// Atlas usado pelas funções de desenho. Só o renderizador carrega e lê o atlas
+AssetAtlas assets;
+
+static SDL_Rect toRect(Sint32 x, Sint32 y, Sint32 w, Sint32 h)
+{
+    SDL_Rect rect = {x, y, w, h};
+    return rect;
+}
+
+// Confere se o cabeçalho é de um pacote desta versão e se os pixels cabem no arquivo
+static bool isAssetPackValid(const AssetPackHeader *header, size_t size)
+{
+    if (size < sizeof(AssetPackHeader) || header->magic != ASSET_PACK_MAGIC)
+    {
+        printf("%s não é um pacote de assets\n", ASSET_PACK_PATH);
+        return false;
+    }
+
+    if (header->version != ASSET_PACK_VERSION)
+    {
+        printf("%s é da versão %u, mas o jogo espera a versão %d. Gere o pacote de novo com o tools/bake_assets\n",
+               ASSET_PACK_PATH, header->version, ASSET_PACK_VERSION);
+        return false;
+    }
+
+    if (header->width <= 0 || header->height <= 0 || header->pitch < header->width * 4 ||
+        header->pixelsOffset + (Uint64)header->pitch * header->height > size)
+    {
+        printf("%s está incompleto\n", ASSET_PACK_PATH);
+        return false;
+    }
+
+    return true;
+}
+
+// Mapeia o pacote gerado pelo tools/bake_assets e cria a textura do atlas direto dos pixels mapeados,
+// sem decodificar PNGs nem copiar os pixels antes de enviar pro renderizador
+bool loadAssets(SDL_Renderer *renderer, AssetAtlas *atlas)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    int file = open(ASSET_PACK_PATH, O_RDONLY);
+    if (file < 0)
+    {
+        printf("Não foi possível abrir %s. Gere o pacote com o tools/bake_assets\n", ASSET_PACK_PATH);
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        printf("Não foi possível ler %s\n", ASSET_PACK_PATH);
+        close(file);
+        return false;
+    }
+
+    size_t size = (size_t)status.st_size;
+    void *pack = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (pack == MAP_FAILED)
+    {
+        printf("Não foi possível mapear %s\n", ASSET_PACK_PATH);
+        return false;
+    }
+
+    const AssetPackHeader *header = (const AssetPackHeader *)pack;
+    if (!isAssetPackValid(header, size))
+    {
+        munmap(pack, size);
+        return false;
+    }
+
+    atlas->width = header->width;
+    atlas->height = header->height;
+    atlas->whiteTexel = toRect(header->whiteTexel[0], header->whiteTexel[1], header->whiteTexel[2], header->whiteTexel[3]);
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        const AssetPackSprite *sprite = &header->sprites[i];
+        atlas->sprites[i] = toRect(sprite->x, sprite->y, sprite->w, sprite->h);
+        atlas->frameWidths[i] = sprite->frameWidth;
+        atlas->frameHeights[i] = sprite->frameHeight;
+    }
+    atlas->packSize = size;
+    atlas->mapTime = SDL_GetPerformanceCounter() - start;
+
+    start = SDL_GetPerformanceCounter();
+    atlas->texture = SDL_CreateTexture(renderer, header->pixelFormat, SDL_TEXTUREACCESS_STATIC, header->width, header->height);
+    if (atlas->texture == NULL || SDL_UpdateTexture(atlas->texture, NULL, (const Uint8 *)pack + header->pixelsOffset, header->pitch) != 0)
+    {
+        printf("Não foi possível criar a textura do atlas. Erro: %s\n", SDL_GetError());
+        destroyAssets(atlas);
+        munmap(pack, size);
+        return false;
+    }
+    atlas->uploadTime = SDL_GetPerformanceCounter() - start;
+
+    // o renderizador guarda a própria cópia dos pixels
+    munmap(pack, size);
+
+    SDL_SetTextureBlendMode(atlas->texture, SDL_BLENDMODE_BLEND);
+    return true;
+}
+
+void printAssetLoadStats(AssetAtlas *atlas)
+{
+    double frequency = (double)SDL_GetPerformanceFrequency();
+
+    printf("Assets: pacote de %zu KB mapeado em %.2f ms, atlas %dx%d enviado em %.2f ms\n",
+           atlas->packSize / 1024, atlas->mapTime * 1000.0 / frequency,
+           atlas->width, atlas->height, atlas->uploadTime * 1000.0 / frequency);
+}
+
+void destroyAssets(AssetAtlas *atlas)
+{
+    if (atlas->texture != NULL)
+        SDL_DestroyTexture(atlas->texture);
+    atlas->texture = NULL;
+}
+
+// Retorna o sub-retângulo do atlas com o quadro da coluna e linha dadas.
+// Assim como o SDL_RenderCopy, recorta o quadro nos limites do spritesheet
+SDL_Rect getSpriteFrame(AssetAtlas *atlas, SpriteId sprite, int column, int row)
+{
+    SDL_Rect bounds = atlas->sprites[sprite];
+    int w = atlas->frameWidths[sprite];
+    int h = atlas->frameHeights[sprite];
+    SDL_Rect frame = {bounds.x + column * w, bounds.y + row * h, w, h};
+    SDL_Rect clipped;
+
+    if (!SDL_IntersectRect(&frame, &bounds, &clipped))
+    {
+        clipped.x = bounds.x;
+        clipped.y = bounds.y;
+        clipped.w = 0;
+        clipped.h = 0;
+    }
+
+    return clipped;
+}
@@ -0,0 +1,80 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+// Pacote gerado pelo tools/bake_assets a partir dos PNGs da pasta sprites/
+#define ASSET_PACK_PATH "sprites/assets.pack"
+#define ASSET_PACK_MAGIC 0x4b504a43 // "CJPK"
+#define ASSET_PACK_VERSION 1
+
+// Identifica cada spritesheet da pasta sprites/
+typedef enum
+{
+    SPRITE_BACKGROUND,
+    SPRITE_LEFT_BUILDING,
+    SPRITE_RIGHT_BUILDING,
+    SPRITE_GROUND,
+    SPRITE_BRIDGE,
+    SPRITE_CANNON,
+    SPRITE_HELICOPTER,
+    SPRITE_HOSTAGE,
+    SPRITE_EXPLOSION,
+    NUM_SPRITES
+} SpriteId;
+
+// Posição de um spritesheet no atlas e o tamanho dos seus quadros, que ficam
+// em uma grade a partir do canto superior esquerdo
+typedef struct
+{
+    Sint32 x;
+    Sint32 y;
+    Sint32 w;
+    Sint32 h;
+    Sint32 frameWidth;
+    Sint32 frameHeight;
+} AssetPackSprite;
+
+// Cabeçalho do pacote. Os pixels do atlas já decodificados vêm logo depois, a partir de pixelsOffset,
+// no formato pixelFormat (um SDL_PIXELFORMAT_*), com pitch bytes por linha
+typedef struct
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 pixelFormat;
+    Sint32 width;
+    Sint32 height;
+    Sint32 pitch;
+    Uint32 pixelsOffset;
+    Sint32 whiteTexel[4];
+    AssetPackSprite sprites[NUM_SPRITES];
+} AssetPackHeader;
+
+// Todos os spritesheets empacotados em uma única textura
+typedef struct
+{
+    SDL_Texture *texture;
+    int width;
+    int height;
+    // sub-retângulo de cada spritesheet dentro do atlas
+    SDL_Rect sprites[NUM_SPRITES];
+    // tamanho dos quadros de cada spritesheet
+    int frameWidths[NUM_SPRITES];
+    int frameHeights[NUM_SPRITES];
+    // bloco branco, usado pra desenhar retângulos sólidos com a mesma textura dos sprites
+    SDL_Rect whiteTexel;
+
+    // Tempos do carregamento (em contagens do SDL_GetPerformanceCounter)
+    Uint64 mapTime;
+    Uint64 uploadTime;
+    size_t packSize;
+} AssetAtlas;
+
+bool loadAssets(SDL_Renderer *renderer, AssetAtlas *atlas);
+void printAssetLoadStats(AssetAtlas *atlas);
+void destroyAssets(AssetAtlas *atlas);
+SDL_Rect getSpriteFrame(AssetAtlas *atlas, SpriteId sprite, int column, int row);
+
+#endif /* ASSETS_H */
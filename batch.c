@@ -0,0 +1,211 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include "batch.h"
+
+void clearDirtyRects(DirtyRects *dirty)
+{
+    dirty->count = 0;
+    dirty->full = false;
+}
+
+void addDirtyRect(DirtyRects *dirty, SDL_Rect rect)
+{
+    if (dirty->full || rect.w <= 0 || rect.h <= 0)
+        return;
+
+    // junta com a primeira região que encostar nela
+    for (int i = 0; i < dirty->count; i++)
+    {
+        if (SDL_HasIntersection(&dirty->rects[i], &rect))
+        {
+            SDL_UnionRect(&dirty->rects[i], &rect, &dirty->rects[i]);
+            return;
+        }
+    }
+
+    if (dirty->count == MAX_DIRTY_RECTS)
+    {
+        dirty->full = true;
+        return;
+    }
+
+    dirty->rects[dirty->count++] = rect;
+}
+
+bool initRenderBatch(RenderBatch *batch, SDL_Renderer *renderer, AssetAtlas *atlas, int capacity)
+{
+    batch->renderer = renderer;
+    batch->atlas = atlas;
+    batch->vertices = (SDL_Vertex *)malloc(sizeof(SDL_Vertex) * 4 * capacity);
+    batch->indices = (int *)malloc(sizeof(int) * 6 * capacity);
+    batch->numQuads = 0;
+    batch->capacity = capacity;
+    batch->dirty = NULL;
+    batch->frames = 0;
+    batch->drawCalls = 0;
+    batch->quads = 0;
+
+    if (batch->vertices == NULL || batch->indices == NULL)
+    {
+        printf("Não foi possível alocar o buffer de quads\n");
+        destroyRenderBatch(batch);
+        return false;
+    }
+
+    // os índices de cada quad (dois triângulos) nunca mudam
+    for (int i = 0; i < capacity; i++)
+    {
+        int *quad = &batch->indices[i * 6];
+        quad[0] = i * 4;
+        quad[1] = i * 4 + 1;
+        quad[2] = i * 4 + 2;
+        quad[3] = i * 4;
+        quad[4] = i * 4 + 2;
+        quad[5] = i * 4 + 3;
+    }
+
+    return true;
+}
+
+void destroyRenderBatch(RenderBatch *batch)
+{
+    free(batch->vertices);
+    free(batch->indices);
+    batch->vertices = NULL;
+    batch->indices = NULL;
+}
+
+// Envia os quads acumulados até agora
+void flushRenderBatch(RenderBatch *batch)
+{
+    if (batch->numQuads == 0)
+        return;
+
+    SDL_RenderGeometry(batch->renderer, batch->atlas->texture, batch->vertices, batch->numQuads * 4, batch->indices, batch->numQuads * 6);
+    batch->drawCalls++;
+    batch->quads += batch->numQuads;
+    batch->numQuads = 0;
+}
+
+// Reserva os 4 vértices do próximo quad
+static SDL_Vertex *nextQuad(RenderBatch *batch)
+{
+    if (batch->numQuads == batch->capacity)
+        flushRenderBatch(batch);
+
+    return &batch->vertices[4 * batch->numQuads++];
+}
+
+// Equivalente ao SDL_RenderCopyEx: o ângulo é em graus, no sentido horário, em torno do centro do destino
+void batchSprite(RenderBatch *batch, const SDL_Rect *srcrect, const SDL_Rect *dstrect, double angle, SDL_RendererFlip flip)
+{
+    if (srcrect->w <= 0 || srcrect->h <= 0)
+        return;
+
+    float u0 = (float)srcrect->x / batch->atlas->width;
+    float v0 = (float)srcrect->y / batch->atlas->height;
+    float u1 = (float)(srcrect->x + srcrect->w) / batch->atlas->width;
+    float v1 = (float)(srcrect->y + srcrect->h) / batch->atlas->height;
+
+    if (flip & SDL_FLIP_HORIZONTAL)
+    {
+        float u = u0;
+        u0 = u1;
+        u1 = u;
+    }
+    if (flip & SDL_FLIP_VERTICAL)
+    {
+        float v = v0;
+        v0 = v1;
+        v1 = v;
+    }
+
+    // cantos em relação ao centro, na ordem superior esquerdo, superior direito,
+    // inferior direito, inferior esquerdo
+    float halfWidth = dstrect->w / 2.0f;
+    float halfHeight = dstrect->h / 2.0f;
+    float centerX = dstrect->x + halfWidth;
+    float centerY = dstrect->y + halfHeight;
+    float corners[4][2] = {{-halfWidth, -halfHeight}, {halfWidth, -halfHeight}, {halfWidth, halfHeight}, {-halfWidth, halfHeight}};
+    float texCoords[4][2] = {{u0, v0}, {u1, v0}, {u1, v1}, {u0, v1}};
+
+    float cosine = 1.0f, sine = 0.0f;
+    if (angle != 0.0)
+    {
+        double radians = angle * M_PI / 180.0;
+        cosine = (float)cos(radians);
+        sine = (float)sin(radians);
+    }
+
+    SDL_Vertex *vertices = nextQuad(batch);
+    for (int i = 0; i < 4; i++)
+    {
+        vertices[i].position.x = centerX + corners[i][0] * cosine - corners[i][1] * sine;
+        vertices[i].position.y = centerY + corners[i][0] * sine + corners[i][1] * cosine;
+        vertices[i].color = (SDL_Color){255, 255, 255, 255};
+        vertices[i].tex_coord.x = texCoords[i][0];
+        vertices[i].tex_coord.y = texCoords[i][1];
+    }
+
+    if (batch->dirty != NULL)
+    {
+        // caixa alinhada aos eixos do quad girado, com um pixel de folga pro arredondamento
+        float minX = vertices[0].position.x, maxX = minX;
+        float minY = vertices[0].position.y, maxY = minY;
+        for (int i = 1; i < 4; i++)
+        {
+            minX = SDL_min(minX, vertices[i].position.x);
+            maxX = SDL_max(maxX, vertices[i].position.x);
+            minY = SDL_min(minY, vertices[i].position.y);
+            maxY = SDL_max(maxY, vertices[i].position.y);
+        }
+        SDL_Rect bounds = {(int)minX - 1, (int)minY - 1, (int)(maxX - minX) + 3, (int)(maxY - minY) + 3};
+        addDirtyRect(batch->dirty, bounds);
+    }
+}
+
+// Retângulo sólido, desenhado com o texel branco do atlas tingido pela cor do vértice
+void batchFillRect(RenderBatch *batch, const SDL_Rect *rect, SDL_Color color)
+{
+    SDL_Rect white = batch->atlas->whiteTexel;
+    float u = (white.x + white.w / 2.0f) / batch->atlas->width;
+    float v = (white.y + white.h / 2.0f) / batch->atlas->height;
+    float positions[4][2] = {
+        {(float)rect->x, (float)rect->y},
+        {(float)(rect->x + rect->w), (float)rect->y},
+        {(float)(rect->x + rect->w), (float)(rect->y + rect->h)},
+        {(float)rect->x, (float)(rect->y + rect->h)},
+    };
+
+    SDL_Vertex *vertices = nextQuad(batch);
+    for (int i = 0; i < 4; i++)
+    {
+        vertices[i].position.x = positions[i][0];
+        vertices[i].position.y = positions[i][1];
+        vertices[i].color = color;
+        vertices[i].tex_coord.x = u;
+        vertices[i].tex_coord.y = v;
+    }
+
+    if (batch->dirty != NULL)
+        addDirtyRect(batch->dirty, *rect);
+}
+
+// Envia o que sobrou do quadro
+void endRenderBatchFrame(RenderBatch *batch)
+{
+    flushRenderBatch(batch);
+    batch->frames++;
+}
+
+void printRenderBatchStats(RenderBatch *batch)
+{
+    if (batch->frames == 0)
+        return;
+
+    printf("Renderização: %.1f chamadas de desenho e %.1f quads por quadro\n",
+           (double)batch->drawCalls / batch->frames, (double)batch->quads / batch->frames);
+}
@@ -0,0 +1,52 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "assets.h"
+
+#ifndef BATCH_H
+#define BATCH_H
+
+// Máximo de regiões sujas guardadas por quadro; acima disso o quadro é redesenhado inteiro
+#define MAX_DIRTY_RECTS 64
+
+// Regiões da tela tocadas pelos quads de um quadro. Retângulos que se sobrepõem são unidos
+typedef struct
+{
+    SDL_Rect rects[MAX_DIRTY_RECTS];
+    int count;
+    // a tela inteira está suja
+    bool full;
+} DirtyRects;
+
+// Acumula os quads de um quadro e envia todos com um único SDL_RenderGeometry.
+// Todos os sprites vêm do mesmo atlas, e os retângulos sólidos (mísseis) usam o
+// texel branco do atlas com a cor no vértice, então a ordem de desenho é preservada
+// sem trocar de textura. Se o buffer enche no meio do quadro, ele é enviado e reaproveitado
+typedef struct
+{
+    SDL_Renderer *renderer;
+    AssetAtlas *atlas;
+    SDL_Vertex *vertices;
+    int *indices;
+    int numQuads;
+    int capacity;
+    // se não for NULL, recebe a região de cada quad
+    DirtyRects *dirty;
+
+    // Estatísticas
+    Uint64 frames;
+    Uint64 drawCalls;
+    Uint64 quads;
+} RenderBatch;
+
+void clearDirtyRects(DirtyRects *dirty);
+void addDirtyRect(DirtyRects *dirty, SDL_Rect rect);
+bool initRenderBatch(RenderBatch *batch, SDL_Renderer *renderer, AssetAtlas *atlas, int capacity);
+void destroyRenderBatch(RenderBatch *batch);
+void batchSprite(RenderBatch *batch, const SDL_Rect *srcrect, const SDL_Rect *dstrect, double angle, SDL_RendererFlip flip);
+void batchFillRect(RenderBatch *batch, const SDL_Rect *rect, SDL_Color color);
+void flushRenderBatch(RenderBatch *batch);
+void endRenderBatchFrame(RenderBatch *batch);
+void printRenderBatchStats(RenderBatch *batch);
+
+#endif /* BATCH_H */
@@ -0,0 +1,218 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "bridge.h"
+#include "trace.h"
+
+// Índice da fila de cada sentido
+#define QUEUE(direction) ((direction) > 0 ? 1 : 0)
+
+static const Uint32 bridgeWaitBucketLimits[BRIDGE_WAIT_BUCKETS - 1] = {0, 10, 20, 50, 100, 200, 500, 1000, 2000};
+
+void initBridge(Bridge *bridge, int x, int width, int numSegments)
+{
+    pthread_mutex_init(&bridge->lock, NULL);
+    bridge->x = x;
+    bridge->width = width;
+    bridge->numSegments = SDL_max(1, SDL_min(numSegments, BRIDGE_MAX_SEGMENTS));
+    for (int i = 0; i < BRIDGE_MAX_SEGMENTS; i++)
+        bridge->occupants[i] = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        bridge->nextTicket[i] = 0;
+        bridge->nowServing[i] = 0;
+        bridge->waiting[i] = 0;
+    }
+    bridge->numCrossing = 0;
+    bridge->direction = 1;
+    bridge->batch = 0;
+
+    bridge->crossings = 0;
+    bridge->waitingCrossings = 0;
+    bridge->directionChanges = 0;
+    bridge->maxQueueLength = 0;
+}
+
+void destroyBridge(Bridge *bridge)
+{
+    pthread_mutex_destroy(&bridge->lock);
+}
+
+bool isOnBridge(Bridge *bridge, SDL_Rect rect)
+{
+    return rect.x + rect.w > bridge->x && rect.x < bridge->x + bridge->width;
+}
+
+// Pega uma senha na fila da ponte. Pode ser chamada antes de chegar na entrada,
+// reservando a vez enquanto o canhão ainda está a caminho
+void reserveBridge(Bridge *bridge, BridgeReservation *reservation, int direction, Uint32 now)
+{
+    if (reservation->state != BRIDGE_IDLE)
+        return;
+
+    int queue = QUEUE(direction);
+
+    Uint64 lockStart = traceBegin();
+    pthread_mutex_lock(&bridge->lock);
+    traceEnd("lock da ponte", "locks", lockStart);
+    reservation->ticket = bridge->nextTicket[queue]++;
+    Uint32 queueLength = bridge->nextTicket[queue] - bridge->nowServing[queue];
+    if (queueLength > bridge->maxQueueLength)
+        bridge->maxQueueLength = queueLength;
+    pthread_mutex_unlock(&bridge->lock);
+
+    reservation->state = BRIDGE_RESERVED;
+    reservation->direction = direction;
+    reservation->reservedAt = now;
+}
+
+static void recordBridgeWait(Bridge *bridge, BridgeReservation *reservation, Uint32 wait)
+{
+    int bucket = 0;
+    while (bucket < BRIDGE_WAIT_BUCKETS - 1 && wait > bridgeWaitBucketLimits[bucket])
+        bucket++;
+
+    reservation->waitHistogram[bucket]++;
+    reservation->crossings++;
+    reservation->totalWait += wait;
+    if (wait > reservation->maxWait)
+        reservation->maxWait = wait;
+
+    bridge->crossings++;
+    if (wait > 0)
+        bridge->waitingCrossings++;
+}
+
+// Tenta entrar na ponte. Se o canhão ainda não tem senha, pega uma agora.
+// Retorna false se não é a vez dele; nesse caso ele deve esperar fora da ponte
+bool enterBridge(Bridge *bridge, BridgeReservation *reservation, int direction, Uint32 now)
+{
+    if (reservation->state == BRIDGE_CROSSING)
+        return true;
+
+    int queue = QUEUE(direction);
+    int opposite = 1 - queue;
+
+    reserveBridge(bridge, reservation, direction, now);
+
+    Uint64 lockStart = traceBegin();
+    pthread_mutex_lock(&bridge->lock);
+    traceEnd("lock da ponte", "locks", lockStart);
+
+    if (reservation->state == BRIDGE_RESERVED)
+    {
+        reservation->state = BRIDGE_WAITING;
+        reservation->arrivedAt = now;
+        bridge->waiting[queue]++;
+    }
+
+    // só o dono da próxima senha do seu sentido pode entrar
+    bool admitted = reservation->ticket == bridge->nowServing[queue];
+    bool batchOver = bridge->batch >= BRIDGE_MAX_BATCH;
+    int entrySegment = direction > 0 ? 0 : bridge->numSegments - 1;
+
+    if (admitted && bridge->direction == direction)
+    {
+        // continua no mesmo sentido até completar o lote, se o outro lado estiver esperando,
+        // e atrás de quem já está na ponte só depois que o segmento de entrada for liberado
+        admitted = (!batchOver || bridge->waiting[opposite] == 0) &&
+                   (bridge->numCrossing == 0 || bridge->occupants[entrySegment] == 0);
+    }
+    else if (admitted)
+    {
+        // troca o sentido só com a ponte vazia, e se ninguém mais do outro lado
+        // está esperando ou se o lote dele já terminou
+        admitted = bridge->numCrossing == 0 && (batchOver || bridge->waiting[QUEUE(bridge->direction)] == 0);
+        if (admitted)
+        {
+            bridge->direction = direction;
+            bridge->batch = 0;
+            bridge->directionChanges++;
+        }
+    }
+
+    if (admitted)
+    {
+        bridge->nowServing[queue]++;
+        bridge->waiting[queue]--;
+        bridge->numCrossing++;
+        bridge->batch++;
+        // o segmento de entrada já fica ocupado, antes mesmo do canhão se mover,
+        // pra que o próximo da fila não entre junto no mesmo tick
+        bridge->occupants[entrySegment]++;
+        recordBridgeWait(bridge, reservation, now - reservation->arrivedAt);
+    }
+
+    pthread_mutex_unlock(&bridge->lock);
+
+    if (admitted)
+    {
+        reservation->state = BRIDGE_CROSSING;
+        reservation->firstSegment = entrySegment;
+        reservation->lastSegment = entrySegment;
+    }
+
+    return admitted;
+}
+
+// Atualiza os segmentos ocupados pelo canhão depois que ele se moveu.
+// Quando o retângulo sai da ponte, a travessia termina
+void moveOnBridge(Bridge *bridge, BridgeReservation *reservation, SDL_Rect rect)
+{
+    if (reservation->state != BRIDGE_CROSSING)
+        return;
+
+    bool crossing = isOnBridge(bridge, rect);
+    int first = 0, last = -1;
+    if (crossing)
+    {
+        int left = SDL_max(rect.x, bridge->x) - bridge->x;
+        int right = SDL_min(rect.x + rect.w, bridge->x + bridge->width) - 1 - bridge->x;
+        first = left * bridge->numSegments / bridge->width;
+        last = right * bridge->numSegments / bridge->width;
+    }
+
+    Uint64 lockStart = traceBegin();
+    pthread_mutex_lock(&bridge->lock);
+    traceEnd("lock da ponte", "locks", lockStart);
+    for (int i = reservation->firstSegment; i <= reservation->lastSegment; i++)
+        bridge->occupants[i]--;
+    for (int i = first; i <= last; i++)
+        bridge->occupants[i]++;
+    if (!crossing)
+        bridge->numCrossing--;
+    pthread_mutex_unlock(&bridge->lock);
+
+    reservation->firstSegment = first;
+    reservation->lastSegment = last;
+    if (!crossing)
+        reservation->state = BRIDGE_IDLE;
+}
+
+void printBridgeStats(Bridge *bridge)
+{
+    if (bridge->crossings == 0)
+        return;
+
+    printf("\nPonte (%d segmentos): %u travessias, %u com espera, %u trocas de sentido, fila máxima de %u canhões\n",
+           bridge->numSegments, bridge->crossings, bridge->waitingCrossings, bridge->directionChanges, bridge->maxQueueLength);
+    printf("Esperas na entrada por faixa (ms): 0");
+    for (int i = 1; i < BRIDGE_WAIT_BUCKETS - 1; i++)
+        printf(" <=%u", bridgeWaitBucketLimits[i]);
+    printf(" >%u\n", bridgeWaitBucketLimits[BRIDGE_WAIT_BUCKETS - 2]);
+}
+
+// Uma linha por canhão, com a contagem de esperas em cada faixa do histograma
+void printBridgeReservationStats(BridgeReservation *reservation, int id)
+{
+    if (reservation->crossings == 0)
+        return;
+
+    printf("  canhão %2d: %3u travessias, espera média %4u ms, pior %5u ms |",
+           id, reservation->crossings, reservation->totalWait / reservation->crossings, reservation->maxWait);
+    for (int i = 0; i < BRIDGE_WAIT_BUCKETS; i++)
+        printf(" %u", reservation->waitHistogram[i]);
+    printf("\n");
+}
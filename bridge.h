@@ -0,0 +1,84 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifndef BRIDGE_H
+#define BRIDGE_H
+
+#define BRIDGE_MAX_SEGMENTS 16
+
+// Quantos canhões seguidos podem entrar no mesmo sentido enquanto há alguém esperando
+// no sentido contrário. Limita a espera de um lado sem desfazer os comboios do outro
+#define BRIDGE_MAX_BATCH 8
+
+// Faixas do histograma de espera, pelo limite superior em ms (a última não tem limite)
+#define BRIDGE_WAIT_BUCKETS 10
+
+typedef enum
+{
+    BRIDGE_IDLE,
+    // tem uma senha, mas ainda não chegou na entrada da ponte
+    BRIDGE_RESERVED,
+    // parado na entrada esperando a vez
+    BRIDGE_WAITING,
+    BRIDGE_CROSSING
+} BridgeReservationState;
+
+// Reserva de um canhão na ponte. Fica dentro do próprio canhão, junto com o histograma
+// dos tempos que ele esperou na entrada
+typedef struct
+{
+    BridgeReservationState state;
+    unsigned int ticket;
+    int direction; // -1 pra esquerda, 1 pra direita
+    Uint32 reservedAt;
+    Uint32 arrivedAt;
+    // segmentos ocupados enquanto atravessa
+    int firstSegment;
+    int lastSegment;
+
+    Uint32 crossings;
+    Uint32 totalWait;
+    Uint32 maxWait;
+    Uint32 waitHistogram[BRIDGE_WAIT_BUCKETS];
+} BridgeReservation;
+
+// Ponte de uma pista dividida em segmentos. Cada sentido tem sua fila de senhas (FIFO).
+// Vários canhões podem atravessar juntos no mesmo sentido, um atrás do outro, desde que
+// o segmento de entrada esteja livre; o sentido contrário espera a ponte esvaziar.
+// Quando os dois lados têm alguém esperando, o sentido troca a cada BRIDGE_MAX_BATCH entradas
+typedef struct
+{
+    pthread_mutex_t lock;
+    int x;
+    int width;
+    int numSegments;
+    int occupants[BRIDGE_MAX_SEGMENTS];
+
+    // filas indexadas por sentido: 0 pra esquerda, 1 pra direita
+    unsigned int nextTicket[2];
+    unsigned int nowServing[2];
+    // canhões parados na entrada de cada lado
+    int waiting[2];
+    int numCrossing;
+    int direction;
+    int batch;
+
+    // Estatísticas de todos os canhões
+    Uint32 crossings;
+    Uint32 waitingCrossings;
+    Uint32 directionChanges;
+    Uint32 maxQueueLength;
+} Bridge;
+
+void initBridge(Bridge *bridge, int x, int width, int numSegments);
+void destroyBridge(Bridge *bridge);
+bool isOnBridge(Bridge *bridge, SDL_Rect rect);
+void reserveBridge(Bridge *bridge, BridgeReservation *reservation, int direction, Uint32 now);
+bool enterBridge(Bridge *bridge, BridgeReservation *reservation, int direction, Uint32 now);
+void moveOnBridge(Bridge *bridge, BridgeReservation *reservation, SDL_Rect rect);
+void printBridgeStats(Bridge *bridge);
+void printBridgeReservationStats(BridgeReservation *reservation, int id);
+
+#endif /* BRIDGE_H */
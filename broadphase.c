@@ -0,0 +1,202 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "broadphase.h"
+
+extern int SCREEN_WIDTH;
+extern int SCREEN_HEIGHT;
+
+void initSpatialGrid(SpatialGrid *grid, int width, int height, int cellSize)
+{
+    grid->cellSize = cellSize;
+    grid->cols = (width + cellSize - 1) / cellSize;
+    grid->rows = (height + cellSize - 1) / cellSize;
+
+    int numCells = grid->cols * grid->rows;
+    grid->cellStart = (int *)calloc(numCells + 1, sizeof(int));
+    grid->cellCursor = (int *)malloc(sizeof(int) * numCells);
+    grid->items = NULL;
+    grid->itemCapacity = 0;
+    grid->boxes = NULL;
+}
+
+void destroySpatialGrid(SpatialGrid *grid)
+{
+    free(grid->cellStart);
+    free(grid->cellCursor);
+    free(grid->items);
+    grid->cellStart = grid->cellCursor = grid->items = NULL;
+}
+
+// Converte o retângulo no intervalo de células que ele cobre.
+// Objetos fora da grade ficam nas células da borda
+static void getCellRange(SpatialGrid *grid, SDL_Rect rect, int *col0, int *row0, int *col1, int *row1)
+{
+    *col0 = SDL_max(0, SDL_min(grid->cols - 1, rect.x / grid->cellSize));
+    *row0 = SDL_max(0, SDL_min(grid->rows - 1, rect.y / grid->cellSize));
+    *col1 = SDL_max(0, SDL_min(grid->cols - 1, (rect.x + rect.w - 1) / grid->cellSize));
+    *row1 = SDL_max(0, SDL_min(grid->rows - 1, (rect.y + rect.h - 1) / grid->cellSize));
+}
+
+// Maior número de células que uma caixa de width x height pode cobrir, em qualquer posição
+int getSpatialGridMaxCells(SpatialGrid *grid, int width, int height)
+{
+    int cols = SDL_min(grid->cols, (width - 1) / grid->cellSize + 2);
+    int rows = SDL_min(grid->rows, (height - 1) / grid->cellSize + 2);
+    return cols * rows;
+}
+
+// Aloca de uma vez espaço pra numItems pares (caixa, célula), pra que as reconstruções
+// que couberem nele não aloquem nada
+void reserveSpatialGrid(SpatialGrid *grid, int numItems)
+{
+    if (numItems <= grid->itemCapacity)
+        return;
+
+    int *items = (int *)realloc(grid->items, sizeof(int) * numItems);
+    if (items == NULL)
+    {
+        printf("Falha ao alocar a grade de colisão (%d itens)\n", numItems);
+        return;
+    }
+    grid->items = items;
+    grid->itemCapacity = numItems;
+}
+
+// Reconstrói a grade em duas passadas: conta os objetos por célula e depois os distribui.
+// Caixas com largura ou altura zero são ignoradas. O array de caixas precisa continuar
+// válido enquanto a grade for consultada
+void buildSpatialGrid(SpatialGrid *grid, const SDL_Rect *boxes, int numBoxes)
+{
+    grid->boxes = boxes;
+
+    int numCells = grid->cols * grid->rows;
+    memset(grid->cellStart, 0, sizeof(int) * (numCells + 1));
+
+    for (int i = 0; i < numBoxes; i++)
+    {
+        if (boxes[i].w <= 0 || boxes[i].h <= 0)
+            continue;
+
+        int col0, row0, col1, row1;
+        getCellRange(grid, boxes[i], &col0, &row0, &col1, &row1);
+        for (int row = row0; row <= row1; row++)
+            for (int col = col0; col <= col1; col++)
+                grid->cellStart[row * grid->cols + col + 1]++;
+    }
+
+    for (int c = 0; c < numCells; c++)
+    {
+        grid->cellStart[c + 1] += grid->cellStart[c];
+        grid->cellCursor[c] = grid->cellStart[c];
+    }
+
+    int numItems = grid->cellStart[numCells];
+    if (numItems > grid->itemCapacity)
+    {
+        reserveSpatialGrid(grid, numItems * 2);
+        // sem memória, a grade fica vazia em vez de escrever fora de items
+        if (numItems > grid->itemCapacity)
+        {
+            memset(grid->cellStart, 0, sizeof(int) * (numCells + 1));
+            return;
+        }
+    }
+
+    for (int i = 0; i < numBoxes; i++)
+    {
+        if (boxes[i].w <= 0 || boxes[i].h <= 0)
+            continue;
+
+        int col0, row0, col1, row1;
+        getCellRange(grid, boxes[i], &col0, &row0, &col1, &row1);
+        for (int row = row0; row <= row1; row++)
+            for (int col = col0; col <= col1; col++)
+                grid->items[grid->cellCursor[row * grid->cols + col]++] = i;
+    }
+}
+
+// Devolve os ids dos objetos nas células cobertas por rect, sem repetição.
+// Retorna quantos candidatos foram escritos (no máximo maxCandidates)
+int querySpatialGrid(SpatialGrid *grid, SDL_Rect rect, int *candidates, int maxCandidates)
+{
+    int numCandidates = 0;
+    int col0, row0, col1, row1;
+    getCellRange(grid, rect, &col0, &row0, &col1, &row1);
+
+    for (int row = row0; row <= row1; row++)
+    {
+        for (int col = col0; col <= col1; col++)
+        {
+            int cell = row * grid->cols + col;
+            for (int k = grid->cellStart[cell]; k < grid->cellStart[cell + 1]; k++)
+            {
+                int id = grid->items[k];
+
+                // um objeto que ocupa várias células só é devolvido na primeira célula
+                // (de cima pra baixo, da esquerda pra direita) comum a ele e à consulta
+                int itemCol0, itemRow0, itemCol1, itemRow1;
+                getCellRange(grid, grid->boxes[id], &itemCol0, &itemRow0, &itemCol1, &itemRow1);
+                if (col != SDL_max(col0, itemCol0) || row != SDL_max(row0, itemRow0))
+                    continue;
+
+                if (numCandidates < maxCandidates)
+                    candidates[numCandidates++] = id;
+            }
+        }
+    }
+
+    return numCandidates;
+}
+
+void initCollisionWorld(CollisionWorld *world, int capacity)
+{
+    world->obstacles = (SDL_Rect **)malloc(sizeof(SDL_Rect *) * capacity);
+    world->boxes = (SDL_Rect *)malloc(sizeof(SDL_Rect) * capacity);
+    world->numObstacles = 0;
+    world->capacity = capacity;
+    initSpatialGrid(&world->grid, SCREEN_WIDTH, SCREEN_HEIGHT, 64);
+}
+
+void destroyCollisionWorld(CollisionWorld *world)
+{
+    free(world->obstacles);
+    free(world->boxes);
+    destroySpatialGrid(&world->grid);
+}
+
+// Registra um obstáculo. O retângulo é lido de novo a cada tick, então pode se mover
+void addCollisionObstacle(CollisionWorld *world, SDL_Rect *rect)
+{
+    if (world->numObstacles == world->capacity)
+        return;
+
+    world->obstacles[world->numObstacles++] = rect;
+}
+
+// Reconstrói a grade dos obstáculos com as posições deste tick
+void stepCollisionWorld(CollisionWorld *world)
+{
+    for (int i = 0; i < world->numObstacles; i++)
+        world->boxes[i] = *world->obstacles[i];
+
+    buildSpatialGrid(&world->grid, world->boxes, world->numObstacles);
+}
+
+// Verifica se o retângulo toca algum obstáculo, testando só os que estão nas mesmas células.
+// Pode ser chamada por várias threads ao mesmo tempo
+bool checkCollisionWorld(CollisionWorld *world, SDL_Rect *rect)
+{
+    int candidates[world->numObstacles > 0 ? world->numObstacles : 1];
+    int numCandidates = querySpatialGrid(&world->grid, *rect, candidates, world->numObstacles);
+
+    for (int i = 0; i < numCandidates; i++)
+    {
+        if (SDL_HasIntersection(rect, &world->boxes[candidates[i]]))
+            return true;
+    }
+
+    return false;
+}
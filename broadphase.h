@@ -0,0 +1,46 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+// Grade uniforme reconstruída a cada tick. Os ids de cada célula ficam contíguos
+// (ordenação por contagem), então a reconstrução é linear no número de objetos.
+// As consultas só leem a grade, então várias threads podem consultar ao mesmo tempo
+typedef struct
+{
+    int cellSize;
+    int cols;
+    int rows;
+    int *cellStart; // cols * rows + 1 posições; os ids da célula c estão em items[cellStart[c]..cellStart[c + 1])
+    int *cellCursor;
+    int *items;
+    int itemCapacity;
+    const SDL_Rect *boxes; // caixas da última reconstrução, indexadas pelo id
+} SpatialGrid;
+
+// Obstáculos que o helicóptero não pode tocar (canhões, chão e prédios)
+typedef struct
+{
+    SDL_Rect **obstacles;
+    SDL_Rect *boxes;
+    int numObstacles;
+    int capacity;
+    SpatialGrid grid;
+} CollisionWorld;
+
+void initSpatialGrid(SpatialGrid *grid, int width, int height, int cellSize);
+void destroySpatialGrid(SpatialGrid *grid);
+int getSpatialGridMaxCells(SpatialGrid *grid, int width, int height);
+void reserveSpatialGrid(SpatialGrid *grid, int numItems);
+void buildSpatialGrid(SpatialGrid *grid, const SDL_Rect *boxes, int numBoxes);
+int querySpatialGrid(SpatialGrid *grid, SDL_Rect rect, int *candidates, int maxCandidates);
+
+void initCollisionWorld(CollisionWorld *world, int capacity);
+void destroyCollisionWorld(CollisionWorld *world);
+void addCollisionObstacle(CollisionWorld *world, SDL_Rect *rect);
+void stepCollisionWorld(CollisionWorld *world);
+bool checkCollisionWorld(CollisionWorld *world, SDL_Rect *rect);
+
+#endif /* BROADPHASE_H */
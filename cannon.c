@@ -1,203 +1,191 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_image.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <pthread.h>
-#include <semaphore.h>
 #include "cannon.h"
-#include "helicopter.h"
+#include "simulation.h"
+#include "assets.h"
 
-extern int CANNON_SPEED;
-extern int AMMUNITION;
 extern int BUILDING_WIDTH;
 extern int CANNON_WIDTH;
-extern int MIN_COOLDOWN_TIME;
-extern int MAX_COOLDOWN_TIME;
 extern int SCREEN_WIDTH;
 extern int BRIDGE_WIDTH;
 extern int MISSILE_WIDTH;
 extern int MISSILE_HEIGHT;
-extern int MISSILE_SPEED;
-extern int RELOAD_TIME_FOR_EACH_MISSILE;
+extern int BASE_SIMULATION_TICK_TIME;
 
-extern pthread_mutex_t bridgeMutex;
+extern AssetAtlas assets;
 
 // Função pra criar um canhão
-CannonInfo createCannon(int x, int y, int w, int h, int initialAmmunition)
+CannonInfo createCannon(int x, int y, int w, int h, int initialAmmunition, int speed)
 {
     CannonInfo cannonInfo;
     cannonInfo.rect.x = x;
     cannonInfo.rect.y = y;
     cannonInfo.rect.w = w;
     cannonInfo.rect.h = h;
-    cannonInfo.speed = CANNON_SPEED;
+    cannonInfo.speed = speed;
     cannonInfo.lastShotTime = SDL_GetTicks();
-    cannonInfo.numActiveMissiles = 0;
-    cannonInfo.missiles = (MissileInfo *)malloc(sizeof(MissileInfo) * AMMUNITION);
     cannonInfo.ammunition = initialAmmunition;
+    cannonInfo.reloading = false;
+    cannonInfo.ticks = 0;
+    cannonInfo.armedTicks = 0;
+    memset(&cannonInfo.bridgeReservation, 0, sizeof(BridgeReservation));
+    seedRandomStream(&cannonInfo.random, 0, 0);
 
-    sem_t sem_empty, ammo_sem;
-    sem_init(&sem_empty, 0, 0);
-    sem_init(&ammo_sem, 0, 1);
+    return cannonInfo;
+}
 
-    cannonInfo.ammunition_semaphore_empty = sem_empty;
-    cannonInfo.ammunition_semaphore_full = ammo_sem;
+// Com que antecedência (em ms) o canhão pega a senha da ponte antes de chegar nela
+#define BRIDGE_RESERVATION_LEAD_TIME 500
 
-    pthread_mutex_t lock;
-    cannonInfo.reloadingLock = lock;
+// Desloca o canhão um passo no sentido indicado, passando pela ponte quando for a vez dele.
+// Enquanto não puder entrar, ele espera parado na entrada, fora da ponte
+static void moveCannonAcrossBridge(Simulation *simulation, CannonInfo *cannonInfo, int direction)
+{
+    Bridge *bridge = &simulation->bridge;
+    Uint32 now = simulation->now;
+    BridgeReservation *reservation = &cannonInfo->bridgeReservation;
+    SDL_Rect next = cannonInfo->rect;
+    next.x += direction * abs(cannonInfo->speed);
+
+    bool onBridge = isOnBridge(bridge, cannonInfo->rect);
+    if (!onBridge && isOnBridge(bridge, next))
+    {
+        if (!enterBridge(bridge, reservation, direction, now))
+            return;
+    }
+    else if (!onBridge)
+    {
+        // reserva a vez quando faltar pouco pra chegar na ponte
+        int distance = direction > 0 ? bridge->x - (next.x + next.w) : next.x - (bridge->x + bridge->width);
+        int leadDistance = abs(cannonInfo->speed) * BRIDGE_RESERVATION_LEAD_TIME / simulation->tuning.tickTime;
+        if (distance >= 0 && distance <= leadDistance)
+            reserveBridge(bridge, reservation, direction, now);
+    }
 
-    return cannonInfo;
+    cannonInfo->rect = next;
+    moveOnBridge(bridge, reservation, cannonInfo->rect);
 }
 
-// Função concorrente para mover a posição lógica dos canhões
-void *moveCannon(void *arg)
+// Avança a lógica de um canhão em um tick, usando o relógio da sessão (em ms)
+void stepCannon(Simulation *simulation, CannonInfo *cannonInfo)
 {
-    MoveCannonThreadParams *params = (MoveCannonThreadParams *)arg;
-    CannonInfo *cannonInfo = params->cannonInfo;
-    HelicopterInfo *helicopterInfo = params->helicopterInfo;
+    GameTuning *tuning = &simulation->tuning;
+    Uint32 now = simulation->now;
 
-    while (1)
-    {
-        // Verifica se o canhão está em cima da ponte
-        if (cannonInfo->rect.x + CANNON_WIDTH > BUILDING_WIDTH && cannonInfo->rect.x < BUILDING_WIDTH + BRIDGE_WIDTH)
-        {
-            // se estiver, bloqueia a passagem na ponte para os demais canhões
-            pthread_mutex_lock(&bridgeMutex);
+    cannonInfo->ticks++;
 
-            // enquanto estiver em cima da ponte, se desloca para sair dela enquanto outros canhões estão bloqueados
-            while (
-                cannonInfo->rect.x + CANNON_WIDTH > BUILDING_WIDTH &&
-                cannonInfo->rect.x < BUILDING_WIDTH + BRIDGE_WIDTH)
-            {
-                // se estiver sem munição, se desloca em direção ao depósito (esquerda)
-                if (cannonInfo->ammunition == 0)
-                    cannonInfo->rect.x -= abs(cannonInfo->speed);
-                else
-                    cannonInfo->rect.x += abs(cannonInfo->speed);
-
-                // Espera 10ms pra controlar a velocidade
-                SDL_Delay(10);
-            }
+    // enquanto recarrega, o canhão fica parado no depósito
+    if (cannonInfo->reloading)
+        return;
 
-            // quando terminar a passagem pela ponte, libera o mutex da ponte
-            pthread_mutex_unlock(&bridgeMutex);
-        }
+    if (cannonInfo->ammunition > 0)
+        cannonInfo->armedTicks++;
 
-        if (cannonInfo->ammunition == 0)
+    if (cannonInfo->ammunition == 0)
+    {
+        // se está sem munição, desloca-se para o depósito, atravessando a ponte
+        if (cannonInfo->rect.x < BUILDING_WIDTH - CANNON_WIDTH)
         {
-            // se está sem munição, desloca-se para o depósito
-            if (cannonInfo->rect.x < BUILDING_WIDTH - CANNON_WIDTH)
-            {
-                // se está no depósito, libera o semáforo para a thread produtora de munições
-                sem_post(&cannonInfo->ammunition_semaphore_empty);
-                // espera até a munição ser recarregada
-                sem_wait(&cannonInfo->ammunition_semaphore_full);
-            }
-            else
-            {
-                cannonInfo->rect.x -= abs(cannonInfo->speed);
-            }
+            // se está no depósito, começa a recarga
+            cannonInfo->reloading = true;
         }
-
         else
         {
-            Uint32 currentTime = SDL_GetTicks();
+            moveCannonAcrossBridge(simulation, cannonInfo, -1);
+        }
+        return;
+    }
+
+    // em cima da ponte o canhão não atira
+    if (!isOnBridge(&simulation->bridge, cannonInfo->rect))
+    {
+        // o cooldown é sorteado uma vez a cada tick base (10 ms) dentro do tick, pra que a
+        // chance de disparar por segundo seja a mesma com qualquer --tick-ms
+        int baseTicks = SDL_min(tuning->tickTime / BASE_SIMULATION_TICK_TIME, (int)(now / BASE_SIMULATION_TICK_TIME) + 1);
+        for (int k = baseTicks - 1; k >= 0; k--)
+        {
+            Uint32 baseNow = now - (Uint32)k * BASE_SIMULATION_TICK_TIME;
 
             // gera um cooldown aleatório entre os limites
-            int cooldown = rand() % (MAX_COOLDOWN_TIME + 1 - MIN_COOLDOWN_TIME) + MIN_COOLDOWN_TIME;
+            int cooldown = nextRandomBelow(&cannonInfo->random, tuning->maxCooldownTime + 1 - tuning->minCooldownTime) + tuning->minCooldownTime;
 
             // verifica se está na hora de disparar outro míssil
-            if (currentTime - cannonInfo->lastShotTime >= cooldown)
+            if (baseNow - cannonInfo->lastShotTime >= (Uint32)cooldown)
             {
-                createMissile(cannonInfo, helicopterInfo);
-                cannonInfo->lastShotTime = currentTime;
+                createMissile(simulation, cannonInfo);
+                cannonInfo->lastShotTime = baseNow;
+                break;
             }
-
-            // Atualiza a posição do canhão
-            cannonInfo->rect.x += cannonInfo->speed;
-
-            // Se o canhão alcançar os limites, inverte a direção
-            if (cannonInfo->rect.x + CANNON_WIDTH > SCREEN_WIDTH - BUILDING_WIDTH)
-                cannonInfo->speed = -CANNON_SPEED;
-            else if (cannonInfo->rect.x <= BUILDING_WIDTH + BRIDGE_WIDTH)
-                cannonInfo->speed = CANNON_SPEED;
         }
+    }
 
-        // Espera 10ms pra controlar a velocidade
-        SDL_Delay(10);
+    if (cannonInfo->rect.x < BUILDING_WIDTH + BRIDGE_WIDTH)
+    {
+        // depois de recarregar, volta pela ponte pra área entre a ponte e o prédio da direita
+        cannonInfo->speed = tuning->cannonSpeed;
+        moveCannonAcrossBridge(simulation, cannonInfo, 1);
+        return;
     }
 
-    return NULL;
-}
+    // Atualiza a posição do canhão
+    cannonInfo->rect.x += cannonInfo->speed;
 
-// thread para os depósitos produtores de munição
-void *reloadCannonAmmunition(void *arg)
-{
-    MoveCannonThreadParams *params = (MoveCannonThreadParams *)arg;
-    CannonInfo *cannonInfo = params->cannonInfo;
-    HelicopterInfo *helicopterInfo = params->helicopterInfo;
+    // Se o canhão alcançar os limites, inverte a direção
+    if (cannonInfo->rect.x + CANNON_WIDTH > SCREEN_WIDTH - BUILDING_WIDTH)
+        cannonInfo->speed = -tuning->cannonSpeed;
+    else if (cannonInfo->rect.x <= BUILDING_WIDTH + BRIDGE_WIDTH)
+        cannonInfo->speed = tuning->cannonSpeed;
+}
 
-    while (1)
-    {
-        // espera até sinalizar que a munição está vazia
-        sem_wait(&cannonInfo->ammunition_semaphore_empty);
+// Parte da munição máxima com que o canhão pode sair do depósito se ele estiver vazio
+#define MIN_TOP_UP_PERCENT 50
 
-        if (cannonInfo->ammunition == 0)
-        {
-            for (int i = 0; i <= AMMUNITION; i++)
-            {
-                SDL_Delay(RELOAD_TIME_FOR_EACH_MISSILE);
-                cannonInfo->ammunition += 1;
-            }
-        }
+// Recarrega o canhão com o que houver no depósito compartilhado. Ele sai quando estiver cheio
+// ou, se o depósito esvaziar, assim que tiver pelo menos MIN_TOP_UP_PERCENT da munição
+void stepCannonReload(Simulation *simulation, CannonInfo *cannonInfo)
+{
+    if (!cannonInfo->reloading)
+        return;
 
-        // libera o array de threads dos mísseis ativos e de retângulos de colisão
-        cannonInfo->numActiveMissiles = 0;
-        helicopterInfo->num_missile_collision_rects = 0;
+    int ammunition = simulation->tuning.ammunition;
+    while (cannonInfo->ammunition < ammunition && drawAmmunition(&simulation->depot))
+        cannonInfo->ammunition++;
 
-        // sinaliza que finalizou a produção da munição
-        sem_post(&cannonInfo->ammunition_semaphore_full);
-    }
+    int minimum = SDL_max(1, ammunition * MIN_TOP_UP_PERCENT / 100);
+    if (cannonInfo->ammunition >= minimum)
+        cannonInfo->reloading = false;
 }
 
 // Função pra criar um míssil
-void createMissile(CannonInfo *cannon, HelicopterInfo *helicopter)
+void createMissile(Simulation *simulation, CannonInfo *cannon)
 {
     if (cannon->ammunition == 0)
     {
         return;
     }
 
-    MissileInfo *missile = &cannon->missiles[cannon->numActiveMissiles];
-    missile->rect.w = MISSILE_WIDTH;
-    missile->rect.h = MISSILE_HEIGHT;
-    missile->rect.x = cannon->rect.x + (CANNON_WIDTH - MISSILE_WIDTH) / 2;
-    missile->rect.y = cannon->rect.y;
-    missile->speed = MISSILE_SPEED;
-    missile->active = true;
-    missile->angle = ((rand() % 120) * M_PI / 180.0);
-
-    // cria a thread desse míssil
-    pthread_t newThread;
-    pthread_create(&newThread, NULL, moveMissiles, &cannon->missiles[cannon->numActiveMissiles]);
-    missile->thread = newThread;
-
-    // adiciona o míssil no array de colisores do helicóptero
-    addHelicopterCollisionMissile(helicopter, &cannon->missiles[cannon->numActiveMissiles]);
-
-    cannon->numActiveMissiles++;
-    cannon->ammunition--;
-}
+    // o míssil é avançado pelo sistema de mísseis, sem criar uma thread própria
+    bool spawned = spawnMissile(
+        &simulation->missileSystem,
+        cannon->rect.x + (CANNON_WIDTH - MISSILE_WIDTH) / 2,
+        cannon->rect.y,
+        simulation->tuning.missileSpeed,
+        nextRandomBelow(&cannon->random, MISSILE_NUM_ANGLES));
 
-void loadCannonSprite(CannonInfo *cannon, SDL_Renderer* renderer) {
-    SDL_Surface * image = IMG_Load("sprites/cannon_spritesheet.png");
-    cannon->texture = SDL_CreateTextureFromSurface(renderer, image);
+    if (spawned)
+    {
+        cannon->ammunition--;
+    }
 }
 
-void drawCannon(CannonInfo *cannon, SDL_Renderer* renderer) {	
+void drawCannon(CannonInfo *cannon, int maxAmmunition, RenderBatch* batch) {	
     Uint32 ticks = SDL_GetTicks();
     Uint32 ms = ticks / 200;
     
-    SDL_Rect srcrect = {(ms % 3) * 50, 225 - ((cannon->ammunition * 9) / AMMUNITION) * 25, 50, 25 };
-    SDL_RenderCopy(renderer, cannon->texture, &srcrect, &cannon->rect);
+    SDL_Rect srcrect = getSpriteFrame(&assets, SPRITE_CANNON, ms % 3, 9 - (cannon->ammunition * 9) / maxAmmunition);
+    batchSprite(batch, &srcrect, &cannon->rect, 0, SDL_FLIP_NONE);
 }
\ No newline at end of file
@@ -2,38 +2,37 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <pthread.h>
-#include <semaphore.h>
-#include "helicopter.h"
+#include "bridge.h"
+#include "batch.h"
+#include "rng.h"
 
 #ifndef CANNON_H
 #define CANNON_H
+
+typedef struct Simulation Simulation;
+
 // Guarda as informações dos objetos
 typedef struct
 {
     SDL_Rect rect;
     int speed;
     Uint32 lastShotTime;
-    MissileInfo *missiles;
-    int numActiveMissiles;
     int ammunition;
-
-    sem_t ammunition_semaphore_empty;
-    sem_t ammunition_semaphore_full;
-    pthread_mutex_t reloadingLock;
-    SDL_Texture *texture;
+    // true enquanto o canhão está parado no depósito recarregando
+    bool reloading;
+    // ticks simulados e ticks em que o canhão estava armado, fora do depósito
+    Uint32 ticks;
+    Uint32 armedTicks;
+    // vez na fila da ponte e histórico das esperas
+    BridgeReservation bridgeReservation;
+    // sequência própria de números aleatórios (cooldown e ângulo dos mísseis)
+    RandomStream random;
 } CannonInfo;
 
-typedef struct
-{
-    HelicopterInfo *helicopterInfo;
-    CannonInfo *cannonInfo;
-} MoveCannonThreadParams;
-
-CannonInfo createCannon(int x, int y, int w, int h, int initialAmmunition);
-void *moveCannon(void *arg);
-void *reloadCannonAmmunition(void *arg);
-void createMissile(CannonInfo *cannon, HelicopterInfo *helicopter);
-void loadCannonSprite(CannonInfo *cannon, SDL_Renderer* renderer);
-void drawCannon(CannonInfo* cannon, SDL_Renderer* renderer);
+CannonInfo createCannon(int x, int y, int w, int h, int initialAmmunition, int speed);
+void stepCannon(Simulation *simulation, CannonInfo *cannonInfo);
+void stepCannonReload(Simulation *simulation, CannonInfo *cannonInfo);
+void createMissile(Simulation *simulation, CannonInfo *cannon);
+void drawCannon(CannonInfo* cannon, int maxAmmunition, RenderBatch* batch);
 
 #endif /* CANNON_H */
\ No newline at end of file
@@ -0,0 +1,35 @@
+// Constantes do jogo, compartilhadas pelo executável e pela biblioteca (environment.h).
+// Todo o estado de uma partida fica na sessão (Simulation)
+const int SCREEN_WIDTH = 1100;
+const int SCREEN_HEIGHT = 700;
+const int GROUND_HEIGHT = 100;
+const int BUILDING_WIDTH = 200;
+const int BUILDING_HEIGHT = 300;
+const int BRIDGE_WIDTH = 150;
+const int BRIDGE_HEIGHT = GROUND_HEIGHT;
+const int CANNON_WIDTH = 100;
+const int CANNON_HEIGHT = 50;
+const int HELICOPTER_WIDTH = 150;
+const int HELICOPTER_HEIGHT = 75;
+const int MISSILE_WIDTH = 5;
+const int MISSILE_HEIGHT = 15;
+const int NUM_HOSTAGES = 10;
+const int HOSTAGE_WIDTH = 15;
+const int HOSTAGE_HEIGHT = 30;
+const int MARGIN_BETWEEN_HOSTAGES = 5;
+const int EXPLOSION_SIZE = 75;
+const int EXPLOSION_FRAMES = 4;
+const int MAX_MISSILES = 4096;
+const int BASE_SIMULATION_TICK_TIME = 10; // milisegundos
+const int DEFAULT_TARGET_FPS = 60;
+
+const int AMMUNITION = 10;
+const int RELOAD_TIME_FOR_EACH_MISSILE = 500; // milisegundos
+const int MIN_COOLDOWN_TIME = 1500;
+const int MAX_COOLDOWN_TIME = 4500;
+
+// Velocidades em pixels por tick base. Cada sessão as ajusta à duração do seu tick,
+// pra que tudo ande o mesmo tanto por segundo com --tick-ms
+const int CANNON_SPEED = 2;
+const int HELICOPTER_SPEED = 3;
+const int MISSILE_SPEED = 5;
@@ -0,0 +1,180 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "depot.h"
+
+// A capacidade é arredondada pra uma potência de 2, pra que a posição vire índice com uma máscara
+bool initAmmunitionRing(AmmunitionRing *ring, int capacity)
+{
+    unsigned int size = 2;
+    while (size < (unsigned int)capacity)
+        size <<= 1;
+
+    ring->cells = (AmmunitionCell *)malloc(sizeof(AmmunitionCell) * size);
+    if (ring->cells == NULL)
+    {
+        printf("Não foi possível alocar o anel do depósito\n");
+        return false;
+    }
+
+    for (unsigned int i = 0; i < size; i++)
+        ring->cells[i].sequence = i;
+
+    ring->mask = size - 1;
+    ring->enqueuePosition = 0;
+    ring->dequeuePosition = 0;
+    return true;
+}
+
+void destroyAmmunitionRing(AmmunitionRing *ring)
+{
+    free(ring->cells);
+    ring->cells = NULL;
+}
+
+// Coloca um míssil no anel. Retorna false se ele estiver cheio
+bool pushAmmunition(AmmunitionRing *ring, int value)
+{
+    unsigned int position = __atomic_load_n(&ring->enqueuePosition, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        AmmunitionCell *cell = &ring->cells[position & ring->mask];
+        unsigned int sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int difference = (int)(sequence - position);
+
+        if (difference == 0)
+        {
+            // a célula está livre: tenta reservar a posição
+            if (__atomic_compare_exchange_n(&ring->enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                cell->value = value;
+                __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            // outro produtor pegou essa posição; o CAS já atualizou position
+        }
+        else if (difference < 0)
+        {
+            // a célula ainda guarda um míssil de uma volta anterior: o anel está cheio
+            return false;
+        }
+        else
+        {
+            position = __atomic_load_n(&ring->enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// Tira um míssil do anel. Retorna false se ele estiver vazio
+bool popAmmunition(AmmunitionRing *ring, int *value)
+{
+    unsigned int position = __atomic_load_n(&ring->dequeuePosition, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        AmmunitionCell *cell = &ring->cells[position & ring->mask];
+        unsigned int sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int difference = (int)(sequence - (position + 1));
+
+        if (difference == 0)
+        {
+            if (__atomic_compare_exchange_n(&ring->dequeuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                *value = cell->value;
+                // libera a célula pra volta seguinte dos produtores
+                __atomic_store_n(&cell->sequence, position + ring->mask + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = __atomic_load_n(&ring->dequeuePosition, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+bool initAmmunitionDepot(AmmunitionDepot *depot, int numProducers, int capacity, Uint32 reloadTime, Uint32 now)
+{
+    if (!initAmmunitionRing(&depot->ring, capacity))
+        return false;
+
+    depot->numProducers = numProducers;
+    depot->reloadTime = reloadTime;
+    depot->producers = (AmmunitionProducer *)calloc(numProducers, sizeof(AmmunitionProducer));
+    if (numProducers > 0 && depot->producers == NULL)
+    {
+        printf("Não foi possível alocar os produtores do depósito\n");
+        destroyAmmunitionRing(&depot->ring);
+        return false;
+    }
+    for (int i = 0; i < numProducers; i++)
+        depot->producers[i].nextProductionTime = now + depot->reloadTime;
+
+    depot->drawn = 0;
+    depot->emptyDraws = 0;
+    return true;
+}
+
+void destroyAmmunitionDepot(AmmunitionDepot *depot)
+{
+    destroyAmmunitionRing(&depot->ring);
+    free(depot->producers);
+    depot->producers = NULL;
+}
+
+// Avança um produtor até "now". Com o anel cheio, a produção para, e o tempo parado
+// não é recuperado depois
+void stepAmmunitionProducer(AmmunitionDepot *depot, int producer, Uint32 now)
+{
+    AmmunitionProducer *info = &depot->producers[producer];
+
+    while ((Sint32)(now - info->nextProductionTime) >= 0)
+    {
+        if (!pushAmmunition(&depot->ring, producer))
+        {
+            info->stalls++;
+            info->nextProductionTime = now + depot->reloadTime;
+            return;
+        }
+
+        info->produced++;
+        info->nextProductionTime += depot->reloadTime;
+    }
+}
+
+// Tira um míssil do depósito pra um canhão. Pode ser chamada por vários canhões ao mesmo tempo
+bool drawAmmunition(AmmunitionDepot *depot)
+{
+    int producer;
+    if (popAmmunition(&depot->ring, &producer))
+    {
+        __atomic_add_fetch(&depot->drawn, 1, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    __atomic_add_fetch(&depot->emptyDraws, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+void printAmmunitionDepotStats(AmmunitionDepot *depot)
+{
+    Uint64 produced = 0, stalls = 0;
+    for (int i = 0; i < depot->numProducers; i++)
+    {
+        produced += depot->producers[i].produced;
+        stalls += depot->producers[i].stalls;
+    }
+
+    printf("\nDepósito (%d produtores, capacidade %u): %llu mísseis produzidos, %llu entregues, %llu vezes parados com o anel cheio, %llu tentativas com o anel vazio\n",
+           depot->numProducers, depot->ring.mask + 1,
+           (unsigned long long)produced,
+           (unsigned long long)depot->drawn,
+           (unsigned long long)stalls,
+           (unsigned long long)depot->emptyDraws);
+}
@@ -0,0 +1,59 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef DEPOT_H
+#define DEPOT_H
+
+// Célula do anel: a sequência diz se ela está livre pra escrita ou pronta pra leitura
+typedef struct
+{
+    unsigned int sequence;
+    int value;
+} AmmunitionCell;
+
+// Anel limitado sem locks com vários produtores e vários consumidores.
+// Cada lado avança o próprio contador com compare-and-swap e só toca na célula que reservou.
+// As posições ficam em linhas de cache separadas pra que produtores e consumidores
+// não disputem a mesma linha
+typedef struct
+{
+    AmmunitionCell *cells;
+    unsigned int mask;
+    unsigned int enqueuePosition __attribute__((aligned(64)));
+    unsigned int dequeuePosition __attribute__((aligned(64)));
+} AmmunitionRing;
+
+// Produtor do depósito: fabrica um míssil a cada reloadTime ms
+typedef struct
+{
+    Uint32 nextProductionTime;
+    Uint32 produced;
+    // vezes em que o anel estava cheio e a produção ficou parada
+    Uint32 stalls;
+} AmmunitionProducer;
+
+// Depósito compartilhado por todos os canhões
+typedef struct
+{
+    AmmunitionRing ring;
+    AmmunitionProducer *producers;
+    int numProducers;
+    Uint32 reloadTime; // ms por míssil, em cada produtor
+
+    Uint64 drawn;
+    Uint64 emptyDraws;
+} AmmunitionDepot;
+
+bool initAmmunitionRing(AmmunitionRing *ring, int capacity);
+void destroyAmmunitionRing(AmmunitionRing *ring);
+bool pushAmmunition(AmmunitionRing *ring, int value);
+bool popAmmunition(AmmunitionRing *ring, int *value);
+
+bool initAmmunitionDepot(AmmunitionDepot *depot, int numProducers, int capacity, Uint32 reloadTime, Uint32 now);
+void destroyAmmunitionDepot(AmmunitionDepot *depot);
+void stepAmmunitionProducer(AmmunitionDepot *depot, int producer, Uint32 now);
+bool drawAmmunition(AmmunitionDepot *depot);
+void printAmmunitionDepotStats(AmmunitionDepot *depot);
+
+#endif /* DEPOT_H */
@@ -0,0 +1,254 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "environment.h"
+
+extern int NUM_HOSTAGES;
+extern int MAX_MISSILES;
+extern int MISSILE_WIDTH;
+extern int MISSILE_HEIGHT;
+
+// Arrays da observação alinhados em 8 bytes
+static Uint32 alignObservationOffset(size_t offset)
+{
+    return (Uint32)((offset + 7) & ~(size_t)7);
+}
+
+// Tamanho do buffer de observação pras opções da sessão: cabeçalho, canhões,
+// helicópteros e espaço pra todos os mísseis que o sistema comporta
+size_t getGameObservationSize(const SessionConfig *config)
+{
+    size_t size = alignObservationOffset(sizeof(GameObservation));
+    size = alignObservationOffset(size + sizeof(ObservedCannon) * SDL_max(config->numCannons, 0));
+    size = alignObservationOffset(size + sizeof(ObservedHelicopter) * SDL_max(config->numHelicopters, 0));
+    return size + sizeof(ObservedMissile) * MAX_MISSILES;
+}
+
+// Preenche os campos do cabeçalho que não mudam durante a vida do ambiente
+static void initGameObservation(GameEnvironment *environment)
+{
+    GameObservation *observation = environment->observation;
+    SessionConfig *config = &environment->config;
+
+    memset(observation, 0, environment->observationSize);
+    observation->magic = GAME_OBSERVATION_MAGIC;
+    observation->version = GAME_OBSERVATION_VERSION;
+    observation->size = environment->observationSize;
+    observation->numCannons = config->numCannons;
+    observation->numHelicopters = config->numHelicopters;
+    observation->missileCapacity = MAX_MISSILES;
+
+    observation->cannonsOffset = alignObservationOffset(sizeof(GameObservation));
+    observation->helicoptersOffset = alignObservationOffset(observation->cannonsOffset + sizeof(ObservedCannon) * config->numCannons);
+    observation->missilesOffset = alignObservationOffset(observation->helicoptersOffset + sizeof(ObservedHelicopter) * config->numHelicopters);
+}
+
+// Copia o estado do fim do tick direto pro buffer, sem alocar nada
+static void writeGameObservation(GameEnvironment *environment, bool done)
+{
+    GameObservation *observation = environment->observation;
+    Simulation *simulation = &environment->simulation;
+    Uint8 *base = (Uint8 *)observation;
+
+    __atomic_store_n(&observation->sequence, observation->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    observation->tick = simulation->tick;
+    observation->done = done;
+    observation->currentHostages = simulation->currentHostages;
+    observation->rescuedHostages = simulation->rescuedHostages;
+
+    ObservedCannon *cannons = (ObservedCannon *)(base + observation->cannonsOffset);
+    for (int i = 0; i < simulation->numCannons; i++)
+    {
+        CannonInfo *cannon = &simulation->cannons[i];
+        cannons[i] = (ObservedCannon){cannon->rect.x, cannon->rect.y, cannon->rect.w, cannon->rect.h,
+                                      cannon->ammunition, cannon->reloading};
+    }
+
+    ObservedHelicopter *helicopters = (ObservedHelicopter *)(base + observation->helicoptersOffset);
+    for (int i = 0; i < simulation->numHelicopters; i++)
+    {
+        HelicopterInfo *helicopter = &simulation->helicopters[i];
+        helicopters[i] = (ObservedHelicopter){helicopter->rect.x, helicopter->rect.y, helicopter->rect.w, helicopter->rect.h,
+                                              helicopter->transportingHostage, helicopter->destroyed};
+    }
+
+    // só os mísseis ativos, na ordem dos arrays densos
+    MissileSystem *missiles = &simulation->missileSystem;
+    ObservedMissile *observedMissiles = (ObservedMissile *)(base + observation->missilesOffset);
+    int count = 0;
+    for (int i = 0; i < missiles->numMissiles && count < observation->missileCapacity; i++)
+    {
+        if (!missiles->active[i])
+            continue;
+
+        observedMissiles[count++] = (ObservedMissile){missiles->x[i] >> MISSILE_SUBPIXEL_BITS, missiles->y[i] >> MISSILE_SUBPIXEL_BITS,
+                                                      MISSILE_WIDTH, MISSILE_HEIGHT, missiles->vx[i], missiles->vy[i]};
+    }
+    observation->numMissiles = count;
+
+    __atomic_store_n(&observation->sequence, observation->sequence + 1, __ATOMIC_RELEASE);
+}
+
+// O episódio acaba como no jogo, quando o helicóptero 0 é destruído ou todos os reféns
+// são resgatados, ou quando chega a maxTicks
+static bool isGameEnvironmentDone(GameEnvironment *environment)
+{
+    Simulation *simulation = &environment->simulation;
+
+    return simulation->helicopters[0].destroyed ||
+           simulation->rescuedHostages == NUM_HOSTAGES ||
+           (environment->maxTicks > 0 && simulation->tick >= environment->maxTicks);
+}
+
+// Cria um ambiente com as opções da sessão e já faz o primeiro reset com config->seed.
+// Se buffer for NULL, o ambiente aloca o seu; senão ele precisa ter pelo menos
+// getGameObservationSize(config) bytes e continua sendo do chamador
+GameEnvironment *createGameEnvironment(const SessionConfig *config, int maxTicks, void *buffer, size_t bufferSize)
+{
+    size_t size = getGameObservationSize(config);
+    if (buffer != NULL && bufferSize < size)
+    {
+        printf("Buffer de observação pequeno demais: %lu bytes, são precisos %lu\n", (unsigned long)bufferSize, (unsigned long)size);
+        return NULL;
+    }
+
+    GameEnvironment *environment = (GameEnvironment *)calloc(1, sizeof(GameEnvironment));
+    environment->config = *config;
+    environment->maxTicks = maxTicks;
+    environment->ownsBuffer = buffer == NULL;
+    environment->observation = (GameObservation *)(buffer != NULL ? buffer : malloc(size));
+    environment->observationSize = size;
+    initGameObservation(environment);
+
+    if (!resetGameEnvironment(environment, config->seed))
+    {
+        destroyGameEnvironment(environment);
+        return NULL;
+    }
+
+    return environment;
+}
+
+// Cria um ambiente cuja observação fica na memória compartilhada "sharedMemoryName"
+// (por exemplo "/jogo-agente-0"), que outro processo abre com shm_open e mapeia só pra leitura
+GameEnvironment *createSharedGameEnvironment(const SessionConfig *config, int maxTicks, const char *sharedMemoryName)
+{
+    size_t size = getGameObservationSize(config);
+
+    int fd = shm_open(sharedMemoryName, O_CREAT | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        printf("Não foi possível criar a memória compartilhada %s\n", sharedMemoryName);
+        return NULL;
+    }
+
+    void *buffer = MAP_FAILED;
+    if (ftruncate(fd, size) == 0)
+        buffer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (buffer == MAP_FAILED)
+    {
+        printf("Não foi possível mapear a memória compartilhada %s\n", sharedMemoryName);
+        shm_unlink(sharedMemoryName);
+        return NULL;
+    }
+
+    GameEnvironment *environment = createGameEnvironment(config, maxTicks, buffer, size);
+    if (environment == NULL)
+    {
+        munmap(buffer, size);
+        shm_unlink(sharedMemoryName);
+        return NULL;
+    }
+
+    environment->sharedMemoryName = strdup(sharedMemoryName);
+    return environment;
+}
+
+void destroyGameEnvironment(GameEnvironment *environment)
+{
+    if (environment->active)
+        destroySimulation(&environment->simulation);
+
+    if (environment->sharedMemoryName != NULL)
+    {
+        munmap(environment->observation, environment->observationSize);
+        shm_unlink(environment->sharedMemoryName);
+        free(environment->sharedMemoryName);
+    }
+    else if (environment->ownsBuffer)
+    {
+        free(environment->observation);
+    }
+
+    free(environment);
+}
+
+// Começa um episódio novo com a semente dada e escreve a observação inicial.
+// É o único ponto, além da criação, em que o ambiente aloca memória
+bool resetGameEnvironment(GameEnvironment *environment, Uint32 seed)
+{
+    if (environment->active)
+        destroySimulation(&environment->simulation);
+
+    environment->config.seed = seed;
+    environment->active = initSimulation(&environment->simulation, &environment->config, NULL);
+    if (!environment->active)
+        return false;
+
+    environment->episodes++;
+    writeGameObservation(environment, false);
+    return true;
+}
+
+// Avança um tick com um comando (bits HELICOPTER_INPUT_*) por helicóptero e escreve a observação.
+// actions NULL deixa todos parados. Retorna true se o episódio acabou
+bool stepGameEnvironment(GameEnvironment *environment, const Uint8 *actions)
+{
+    if (!environment->active || environment->observation->done)
+        return true;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    Simulation *simulation = &environment->simulation;
+
+    if (actions != NULL)
+        memcpy(simulation->helicopterInputs, actions, simulation->numHelicopters);
+    else
+        memset(simulation->helicopterInputs, 0, simulation->numHelicopters);
+
+    stepSimulation(simulation);
+
+    bool done = isGameEnvironmentDone(environment);
+    writeGameObservation(environment, done);
+
+    environment->steps++;
+    environment->totalStepTime += SDL_GetPerformanceCounter() - start;
+    return done;
+}
+
+const GameObservation *getGameObservation(GameEnvironment *environment)
+{
+    return environment->observation;
+}
+
+void printGameEnvironmentStats(GameEnvironment *environment)
+{
+    if (environment->steps == 0)
+        return;
+
+    double seconds = (double)environment->totalStepTime / SDL_GetPerformanceFrequency();
+    printf("Ambiente: %llu passos em %llu episódios, %.2f us por passo (%.0f passos/s), observação de %lu bytes\n",
+           (unsigned long long)environment->steps,
+           (unsigned long long)environment->episodes,
+           seconds * 1e6 / environment->steps,
+           environment->steps / seconds,
+           (unsigned long)environment->observationSize);
+}
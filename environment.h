@@ -0,0 +1,97 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "simulation.h"
+#include "recording.h"
+
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+// Interface pra controlar o jogo de fora, por exemplo a partir de um agente: cada chamada
+// a stepGameEnvironment avança a sessão um tick com os comandos recebidos e escreve o estado
+// resultante num buffer de observação com layout binário fixo. O buffer é do chamador ou
+// fica numa memória compartilhada (/dev/shm), que outro processo lê sem cópia. Depois da
+// criação, nenhum passo aloca memória ou serializa nada
+
+#define GAME_OBSERVATION_MAGIC 0x424f4a43 // "CJOB"
+#define GAME_OBSERVATION_VERSION 1
+
+// Cabeçalho da observação. Os arrays vêm depois, nas posições indicadas pelos offsets
+// (em bytes, a partir do começo do cabeçalho). Todos os campos são inteiros de 32 bits
+// na ordem de bytes da máquina
+typedef struct
+{
+    Uint32 magic;
+    Uint32 version;
+    // ímpar enquanto a observação está sendo escrita; quem lê de outro processo confere
+    // se o valor é par e igual antes e depois da leitura
+    Uint32 sequence;
+    Uint32 size; // tamanho total do buffer usado, em bytes
+
+    Sint32 tick;
+    Sint32 done; // 1 quando o episódio acabou e é preciso chamar resetGameEnvironment
+    Sint32 currentHostages;
+    Sint32 rescuedHostages;
+
+    Sint32 numCannons;
+    Sint32 numHelicopters;
+    Sint32 numMissiles; // mísseis ativos neste tick
+    Sint32 missileCapacity;
+
+    Uint32 cannonsOffset;
+    Uint32 helicoptersOffset;
+    Uint32 missilesOffset;
+    Uint32 reserved;
+} GameObservation;
+
+// Posições e tamanhos em pixels
+typedef struct
+{
+    Sint32 x, y, w, h;
+    Sint32 ammunition;
+    Sint32 reloading;
+} ObservedCannon;
+
+typedef struct
+{
+    Sint32 x, y, w, h;
+    Sint32 transportingHostage;
+    Sint32 destroyed;
+} ObservedHelicopter;
+
+// Posição em pixels e velocidade em sub-pixels por tick (MISSILE_SUBPIXEL_ONE por pixel)
+typedef struct
+{
+    Sint32 x, y, w, h;
+    Sint32 vx, vy;
+} ObservedMissile;
+
+typedef struct
+{
+    SessionConfig config;
+    int maxTicks; // 0 = o episódio só acaba com a destruição do helicóptero 0 ou o resgate de todos os reféns
+    Simulation simulation;
+    bool active;
+
+    GameObservation *observation;
+    size_t observationSize;
+    bool ownsBuffer;
+    // memória compartilhada, se criada com um nome
+    char *sharedMemoryName;
+
+    // Estatísticas
+    Uint64 steps;
+    Uint64 episodes;
+    Uint64 totalStepTime;
+} GameEnvironment;
+
+size_t getGameObservationSize(const SessionConfig *config);
+GameEnvironment *createGameEnvironment(const SessionConfig *config, int maxTicks, void *buffer, size_t bufferSize);
+GameEnvironment *createSharedGameEnvironment(const SessionConfig *config, int maxTicks, const char *sharedMemoryName);
+void destroyGameEnvironment(GameEnvironment *environment);
+bool resetGameEnvironment(GameEnvironment *environment, Uint32 seed);
+bool stepGameEnvironment(GameEnvironment *environment, const Uint8 *actions);
+const GameObservation *getGameObservation(GameEnvironment *environment);
+void printGameEnvironmentStats(GameEnvironment *environment);
+
+#endif /* ENVIRONMENT_H */
@@ -0,0 +1,99 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "headless.h"
+#include "simulation.h"
+#include "script.h"
+#include "savestate.h"
+#include "rewind.h"
+
+extern int NUM_HOSTAGES;
+
+// Confere o retrocesso: volta pro estado mais antigo guardado, simula de novo até o mesmo tick
+// e compara com o estado em que a sessão tinha terminado. Se divergirem, mostra a primeira
+// seção diferente, que é por onde começar a procurar a falta de determinismo
+static bool verifyRewind(Simulation *simulation, HelicopterScript *script)
+{
+    SaveState finalState, repeatedState;
+    bool allocated = initSaveState(&finalState, getMaxSaveStateSize(simulation));
+    allocated = initSaveState(&repeatedState, getMaxSaveStateSize(simulation)) && allocated;
+    if (!allocated)
+    {
+        freeSaveState(&finalState);
+        freeSaveState(&repeatedState);
+        return false;
+    }
+    saveSimulationState(simulation, &finalState);
+
+    int finalTick = simulation->tick;
+    int tick = rewindSimulation(simulation->rewind, simulation, finalTick - getOldestRewindTick(simulation->rewind));
+    if (tick >= 0)
+    {
+        while (simulation->tick < finalTick)
+        {
+            fillScriptedHelicopterInputs(simulation, script, 0);
+            stepSimulation(simulation);
+        }
+        saveSimulationState(simulation, &repeatedState);
+    }
+
+    int section = tick >= 0 ? findSaveStateDifference(&finalState, &repeatedState) : -1;
+    if (tick < 0)
+        printf("Retrocesso: nenhum estado guardado pra conferir\n");
+    else if (section < 0)
+        printf("Retrocesso: voltando do tick %d ao %d e simulando de novo, o estado final é idêntico\n", finalTick, tick);
+    else
+        printf("Retrocesso: voltando do tick %d ao %d, o estado final diverge a partir da seção %s\n",
+               finalTick, tick, getSaveStateSectionName(section));
+
+    freeSaveState(&finalState);
+    freeSaveState(&repeatedState);
+    return section < 0;
+}
+
+// Roda a simulação sem janela, o mais rápido possível, em um relógio virtual de passo fixo.
+// Todos os helicópteros seguem o roteiro, cada um defasado do anterior
+int runHeadless(HeadlessConfig *config, Simulation *simulation)
+{
+    HelicopterScript script;
+    if (!loadHelicopterScript(&script, config->scriptPath))
+        return 1;
+
+    int destroyedTick = -1;
+    int rescuedAllTick = -1;
+
+    Uint64 wallStart = SDL_GetPerformanceCounter();
+
+    for (int tick = 0; tick < config->ticks; tick++)
+    {
+        fillScriptedHelicopterInputs(simulation, &script, 0);
+        stepSimulation(simulation);
+
+        // contados a partir do tick 0 da sessão, mesmo que ela tenha vindo de um estado salvo
+        if (simulation->destroyed && destroyedTick < 0)
+            destroyedTick = simulation->tick - 1;
+        if (simulation->rescuedHostages == NUM_HOSTAGES && rescuedAllTick < 0)
+            rescuedAllTick = simulation->tick - 1;
+    }
+
+    double wallTime = (double)(SDL_GetPerformanceCounter() - wallStart) / SDL_GetPerformanceFrequency();
+    double simulatedTime = (double)config->ticks * simulation->tuning.tickTime / 1000.0;
+
+    printf("Simulação headless: %d canhões, %d helicópteros\n", simulation->numCannons, simulation->numHelicopters);
+    printf("%d ticks (%.1f s simulados) em %.3f s de relógio\n", config->ticks, simulatedTime, wallTime);
+    if (wallTime > 0)
+        printf("Vazão: %.0f ticks/s (%.1fx o tempo real)\n", config->ticks / wallTime, simulatedTime / wallTime);
+    printf("Reféns: %d no prédio, %d resgatados\n", simulation->currentHostages, simulation->rescuedHostages);
+    if (destroyedTick >= 0)
+        printf("Primeiro helicóptero destruído no tick %d\n", destroyedTick);
+    if (rescuedAllTick >= 0)
+        printf("Todos os reféns resgatados no tick %d\n", rescuedAllTick);
+
+    int result = 0;
+    if (simulation->rewind != NULL && !verifyRewind(simulation, &script))
+        result = 1;
+
+    freeHelicopterScript(&script);
+    return result;
+}
@@ -0,0 +1,17 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "simulation.h"
+
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+typedef struct
+{
+    int ticks;
+    const char *scriptPath; // NULL usa o roteiro padrão
+} HeadlessConfig;
+
+int runHeadless(HeadlessConfig *config, Simulation *simulation);
+
+#endif /* HEADLESS_H */
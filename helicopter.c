@@ -1,25 +1,20 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_image.h>
 #include <stdio.h>
 #include <pthread.h>
 #include "helicopter.h"
-#include "scenario.h"
+#include "simulation.h"
+#include "assets.h"
 
-extern int currentHostages;
-extern int rescuedHostages;
 extern int HELICOPTER_WIDTH;
 extern int BUILDING_WIDTH;
 extern int NUM_HOSTAGES;
 extern int SCREEN_WIDTH;
 extern int BUILDING_WIDTH;
 extern int SCREEN_HEIGHT;
-extern int AMMUNITION;
-extern ScenarioElementInfo rightBuilding;
-extern ScenarioElementInfo leftBuilding;
-extern bool destroyed;
+extern AssetAtlas assets;
 
 // Função pra criar um helicótero
-HelicopterInfo createHelicopter(int x, int y, int w, int h, int speed, SDL_Rect **collisionRectArray)
+HelicopterInfo createHelicopter(int x, int y, int w, int h, int speed)
 {
     HelicopterInfo helicopterInfo;
     helicopterInfo.rect.x = x;
@@ -27,36 +22,19 @@ HelicopterInfo createHelicopter(int x, int y, int w, int h, int speed, SDL_Rect
     helicopterInfo.rect.w = w;
     helicopterInfo.rect.h = h;
     helicopterInfo.speed = speed;
-    helicopterInfo.fixed_collision_rects = collisionRectArray;
-    helicopterInfo.missile_collision_rects = (MissileInfo **)malloc(sizeof(MissileInfo *) * AMMUNITION);
-    helicopterInfo.num_missile_collision_rects = 0;
     helicopterInfo.transportingHostage = false;
+    helicopterInfo.destroyed = false;
     helicopterInfo.currentMovement = 0;
     return helicopterInfo;
 }
 
-void addHelicopterCollisionMissile(HelicopterInfo *helicopter, MissileInfo *missile)
+// Testa o caminho inteiro do helicóptero no tick, de from até to, contra os mísseis
+bool checkMissileCollisions(SDL_Rect from, SDL_Rect to, MissileSystem *missileSystem)
 {
-    helicopter->missile_collision_rects[helicopter->num_missile_collision_rects] = missile;
-    helicopter->num_missile_collision_rects++;
+    return checkMissileSystemCollision(missileSystem, &from, &to);
 }
 
-void checkMissileCollisions(SDL_Rect helicopterRect, MissileInfo *missiles[], int missiles_length)
-{
-    for (int i = 0; i < missiles_length; i++)
-    {
-        if (&missiles[i]->active)
-        {
-            SDL_Rect *collisionRect = &missiles[i]->rect;
-            if (SDL_HasIntersection(&helicopterRect, collisionRect))
-            {
-                destroyed = true;
-            }
-        }
-    }
-}
-
-void checkHelicopterCollisions(SDL_Rect helicopterRect, SDL_Rect *rects[], int rects_length)
+bool checkHelicopterCollisions(SDL_Rect helicopterRect, CollisionWorld *collisionWorld)
 {
     if (
         helicopterRect.x < -(helicopterRect.w * 0.2) ||
@@ -64,124 +42,103 @@ void checkHelicopterCollisions(SDL_Rect helicopterRect, SDL_Rect *rects[], int r
         helicopterRect.y < -(helicopterRect.h * 0.2) ||
         helicopterRect.y > SCREEN_HEIGHT + (helicopterRect.h * 0.2)
     ) {
-        destroyed = true;
+        return true;
     }
 
-    for (int i = 0; i < rects_length; i++)
+    return checkCollisionWorld(collisionWorld, &helicopterRect);
+}
+
+// Converte uma tecla no comando do helicóptero correspondente (0 se a tecla não controla o helicóptero)
+Uint8 getHelicopterKeyInput(SDL_Scancode scancode)
+{
+    switch (scancode)
     {
-        SDL_Rect *collisionRect = rects[i];
-        if (SDL_HasIntersection(&helicopterRect, collisionRect))
-        {
-            destroyed = true;
-        }
+    case SDL_SCANCODE_LEFT:
+        return HELICOPTER_INPUT_LEFT;
+    case SDL_SCANCODE_RIGHT:
+        return HELICOPTER_INPUT_RIGHT;
+    case SDL_SCANCODE_UP:
+        return HELICOPTER_INPUT_UP;
+    case SDL_SCANCODE_DOWN:
+        return HELICOPTER_INPUT_DOWN;
+    default:
+        return 0;
     }
 }
 
-// Função concorrente para mover o helicóptero que é controlado pelo usuário
-void *moveHelicopter(void *arg)
+// Avança a lógica do helicóptero em um tick a partir dos comandos recebidos.
+// Vários helicópteros podem ser atualizados ao mesmo tempo em threads diferentes
+void stepHelicopter(Simulation *simulation, HelicopterInfo *helicopterInfo, Uint8 input)
 {
-    HelicopterInfo *helicopterInfo = (HelicopterInfo *)arg;
+    // um helicóptero destruído não se move mais
+    if (helicopterInfo->destroyed)
+        return;
+
+    helicopterInfo->currentMovement = 0;
 
-    while (1)
+    if (input & HELICOPTER_INPUT_LEFT)
+    {
+        helicopterInfo->rect.x -= helicopterInfo->speed;
+        helicopterInfo->currentMovement = 1;
+    }
+    if (input & HELICOPTER_INPUT_RIGHT)
+    {
+        helicopterInfo->rect.x += helicopterInfo->speed;
+        helicopterInfo->currentMovement = 2;
+    }
+    if (input & HELICOPTER_INPUT_UP)
     {
-        helicopterInfo->currentMovement = 0;
-        const Uint8 *keystates = SDL_GetKeyboardState(NULL);
-
-        // Checa o estado atual do teclado pra ver se está pressionado
-        if (keystates[SDL_SCANCODE_LEFT])
-        {
-            helicopterInfo->rect.x -= helicopterInfo->speed;
-            helicopterInfo->currentMovement = 1;
-        }
-        if (keystates[SDL_SCANCODE_RIGHT])
-        {
-            helicopterInfo->rect.x += helicopterInfo->speed;
-            helicopterInfo->currentMovement = 2;
-        }
-        if (keystates[SDL_SCANCODE_UP])
-        {
-            helicopterInfo->rect.y -= helicopterInfo->speed;
-        }
-        if (keystates[SDL_SCANCODE_DOWN])
-        {
-            helicopterInfo->rect.y += helicopterInfo->speed;
-        }
-
-        // checa colisão com canhões e objetos do cenário
-        checkHelicopterCollisions(
-            helicopterInfo->rect,
-            helicopterInfo->fixed_collision_rects,
-            5);
-
-        // checa colisão com os mísseis
-        checkMissileCollisions(
-            helicopterInfo->rect,
-            helicopterInfo->missile_collision_rects,
-            helicopterInfo->num_missile_collision_rects);
-
-        // se está no topo do prédio esquerdo e ainda há reféns, inicia o transporte do refém
-        if (currentHostages > 0 && helicopterInfo->rect.x + HELICOPTER_WIDTH < BUILDING_WIDTH && !helicopterInfo->transportingHostage)
-        {
-            helicopterInfo->transportingHostage = true;
-            currentHostages--;
-        }
-
-        // se está no topo do prédio à direita e está transportando um refém, finaliza o resgate
-        if (rescuedHostages < NUM_HOSTAGES && helicopterInfo->rect.x > SCREEN_WIDTH - BUILDING_WIDTH && helicopterInfo->transportingHostage)
-        {
-            helicopterInfo->transportingHostage = false;
-            rescuedHostages++;
-        }
-
-        // Espera 10ms pra controlar a velocidade
-        SDL_Delay(10);
+        helicopterInfo->rect.y -= helicopterInfo->speed;
+    }
+    if (input & HELICOPTER_INPUT_DOWN)
+    {
+        helicopterInfo->rect.y += helicopterInfo->speed;
     }
 
-    return NULL;
-}
+    // checa colisão com canhões e objetos do cenário; os mísseis são testados depois que
+    // se movem no tick, em checkHelicopterMissileHit
+    if (checkHelicopterCollisions(helicopterInfo->rect, &simulation->collisionWorld))
+    {
+        helicopterInfo->destroyed = true;
+        simulation->destroyed = true;
+    }
 
-// Função concorrente para mover os mísseis
-void *moveMissiles(void *arg)
-{
-    MissileInfo *missileInfo = (MissileInfo *)arg;
+    // os contadores de reféns são compartilhados por todos os helicópteros
+    pthread_mutex_lock(&simulation->hostagesMutex);
 
-    while (1)
+    // se está no topo do prédio esquerdo e ainda há reféns, inicia o transporte do refém
+    if (simulation->currentHostages > 0 && helicopterInfo->rect.x + HELICOPTER_WIDTH < BUILDING_WIDTH && !helicopterInfo->transportingHostage)
     {
+        helicopterInfo->transportingHostage = true;
+        simulation->currentHostages--;
+    }
 
-        if (missileInfo->active)
-        {
-            // Atualiza as posições lógicas do míssil se estiver ativo
-            missileInfo->rect.x += (int)(missileInfo->speed * cos(missileInfo->angle));
-            missileInfo->rect.y -= (int)(missileInfo->speed * sin(missileInfo->angle));
-
-            // Desativa o míssil se ele sair da tela
-            if (
-                missileInfo->rect.x < 0 ||
-                missileInfo->rect.x > SCREEN_WIDTH ||
-                missileInfo->rect.y < 0 ||
-                missileInfo->rect.y > SCREEN_HEIGHT ||
-                SDL_HasIntersection(&missileInfo->rect, &rightBuilding.rect) ||
-                SDL_HasIntersection(&missileInfo->rect, &leftBuilding.rect))
-            {
-                missileInfo->active = false;
-
-                // se o míssil não estiver mais ativo, destrói sua thread
-                pthread_cancel(missileInfo->thread);
-            }
-        }
-
-        SDL_Delay(10);
+    // se está no topo do prédio à direita e está transportando um refém, finaliza o resgate
+    if (simulation->rescuedHostages < NUM_HOSTAGES && helicopterInfo->rect.x > SCREEN_WIDTH - BUILDING_WIDTH && helicopterInfo->transportingHostage)
+    {
+        helicopterInfo->transportingHostage = false;
+        simulation->rescuedHostages++;
     }
 
-    return NULL;
+    pthread_mutex_unlock(&simulation->hostagesMutex);
 }
 
-void loadHelicopterSprite(HelicopterInfo *helicopter, SDL_Renderer* renderer) {
-    SDL_Surface * image = IMG_Load("sprites/helicopter_spritesheet.png");
-    helicopter->texture = SDL_CreateTextureFromSurface(renderer, image);
+// Testa o caminho do helicóptero no tick, de previousRect até a posição atual, contra o
+// caminho dos mísseis no mesmo tick. Roda depois que os mísseis se movem e antes de serem
+// desativados por sair da tela ou bater num prédio, então nenhum cruzamento fica de fora
+void checkHelicopterMissileHit(Simulation *simulation, HelicopterInfo *helicopterInfo, SDL_Rect previousRect)
+{
+    if (helicopterInfo->destroyed)
+        return;
+
+    if (checkMissileCollisions(previousRect, helicopterInfo->rect, &simulation->missileSystem))
+    {
+        helicopterInfo->destroyed = true;
+        simulation->destroyed = true;
+    }
 }
 
-void drawHelicopter(HelicopterInfo *helicopter, SDL_Renderer* renderer) {	
+void drawHelicopter(HelicopterInfo *helicopter, RenderBatch* batch) {	
     Uint32 ticks = SDL_GetTicks();
     Uint32 ms = ticks / 200;
     
@@ -198,6 +155,6 @@ void drawHelicopter(HelicopterInfo *helicopter, SDL_Renderer* renderer) {
         angleDirection = 15;
     }
 
-    SDL_Rect srcrect = {(ms % 4) * 100, helicopter->transportingHostage * 50, 100, 50};
-    SDL_RenderCopyEx(renderer, helicopter->texture, &srcrect, &helicopter->rect, angleDirection, NULL, helicopterHorizontalDirection);
+    SDL_Rect srcrect = getSpriteFrame(&assets, SPRITE_HELICOPTER, ms % 4, helicopter->transportingHostage);
+    batchSprite(batch, &srcrect, &helicopter->rect, angleDirection, helicopterHorizontalDirection);
 }
\ No newline at end of file
@@ -2,29 +2,27 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <pthread.h>
+#include "missile.h"
+#include "broadphase.h"
+#include "batch.h"
 
 #ifndef HELICOPTER_H
 #define HELICOPTER_H
 
-// Guarda as informações dos mísseis
-typedef struct
-{
-    SDL_Rect rect;
-    int speed;
-    bool active;
-    double angle;
-    pthread_t thread;
-} MissileInfo;
+typedef struct Simulation Simulation;
+
+// Comandos do helicóptero em um tick, combinados como bits
+#define HELICOPTER_INPUT_LEFT (1 << 0)
+#define HELICOPTER_INPUT_RIGHT (1 << 1)
+#define HELICOPTER_INPUT_UP (1 << 2)
+#define HELICOPTER_INPUT_DOWN (1 << 3)
 
 typedef struct
 {
     SDL_Rect rect;
     int speed;
-    SDL_Rect **fixed_collision_rects;
-    MissileInfo **missile_collision_rects;
-    int num_missile_collision_rects;
     bool transportingHostage;
-    SDL_Texture *texture;
+    bool destroyed;
     /**
      * 0 - Parado
      * 1 - Andando pra esquerda
@@ -33,13 +31,12 @@ typedef struct
     int currentMovement;
 } HelicopterInfo;
 
-HelicopterInfo createHelicopter(int x, int y, int w, int h, int speed, SDL_Rect **collisionRectArray);
-void addHelicopterCollisionMissile(HelicopterInfo *helicopter, MissileInfo *missile);
-void *moveMissiles(void *arg);
-void checkMissileCollisions(SDL_Rect helicopterRect, MissileInfo *missiles[], int missiles_length);
-void checkHelicopterCollisions(SDL_Rect helicopterRect, SDL_Rect *rects[], int rects_length);
-void *moveHelicopter(void *arg);
-void loadHelicopterSprite(HelicopterInfo *helicopter, SDL_Renderer* renderer);
-void drawHelicopter(HelicopterInfo* helicopter, SDL_Renderer* renderer);
+HelicopterInfo createHelicopter(int x, int y, int w, int h, int speed);
+bool checkMissileCollisions(SDL_Rect from, SDL_Rect to, MissileSystem *missileSystem);
+bool checkHelicopterCollisions(SDL_Rect helicopterRect, CollisionWorld *collisionWorld);
+Uint8 getHelicopterKeyInput(SDL_Scancode scancode);
+void stepHelicopter(Simulation *simulation, HelicopterInfo *helicopterInfo, Uint8 input);
+void checkHelicopterMissileHit(Simulation *simulation, HelicopterInfo *helicopterInfo, SDL_Rect previousRect);
+void drawHelicopter(HelicopterInfo* helicopter, RenderBatch* batch);
 
 #endif /* HELICOPTER_H */
\ No newline at end of file
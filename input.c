@@ -0,0 +1,118 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include "input.h"
+
+#define INPUT_QUEUE_MASK (INPUT_QUEUE_CAPACITY - 1)
+
+void initInputQueue(InputQueue *queue)
+{
+    memset(queue, 0, sizeof(InputQueue));
+}
+
+// Chamada só pela thread principal. Com a fila cheia, o evento é descartado
+bool pushInputEvent(InputQueue *queue, Uint8 key, bool pressed, Uint64 timestamp)
+{
+    Uint32 tail = queue->tail;
+
+    // o slot só pode ser reaproveitado depois de consumido e de ter a latência medida,
+    // já que a medição lê o instante guardado nele. Como um evento só é medido depois de
+    // consumido, basta olhar os medidos
+    if (tail - queue->presented == INPUT_QUEUE_CAPACITY)
+    {
+        queue->dropped++;
+        return false;
+    }
+
+    InputEvent *event = &queue->events[tail & INPUT_QUEUE_MASK];
+    event->timestamp = timestamp;
+    event->key = key;
+    event->pressed = pressed;
+
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Chamada só pela simulação, antes de cada tick. Aplica todos os eventos que chegaram
+// e retorna as teclas pressionadas
+Uint8 consumeInputEvents(InputQueue *queue, Uint64 now)
+{
+    Uint32 head = queue->head;
+    Uint32 tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+
+    for (; head != tail; head++)
+    {
+        InputEvent *event = &queue->events[head & INPUT_QUEUE_MASK];
+        if (event->pressed)
+            queue->state |= event->key;
+        else
+            queue->state &= ~event->key;
+
+        Uint64 latency = now > event->timestamp ? now - event->timestamp : 0;
+        queue->consumedLatency += latency;
+        if (latency > queue->maxConsumedLatency)
+            queue->maxConsumedLatency = latency;
+    }
+
+    __atomic_store_n(&queue->head, head, __ATOMIC_RELEASE);
+    return queue->state;
+}
+
+// Total de eventos já aplicados pela simulação, guardado em cada snapshot
+Uint32 getConsumedInputEvents(InputQueue *queue)
+{
+    return queue->head;
+}
+
+// Chamada pela thread principal depois de apresentar um quadro com um snapshot que já
+// tinha aplicado "consumed" eventos. Cada evento é medido uma única vez
+void recordInputLatency(InputQueue *queue, Uint32 consumed, Uint64 presentedAt)
+{
+    double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+
+    for (; (Sint32)(consumed - queue->presented) > 0; queue->presented++)
+    {
+        InputEvent *event = &queue->events[queue->presented & INPUT_QUEUE_MASK];
+        Uint64 latency = presentedAt > event->timestamp ? presentedAt - event->timestamp : 0;
+        queue->measured++;
+        queue->totalLatency += latency;
+        if (latency > queue->maxLatency)
+            queue->maxLatency = latency;
+
+        int bucket = (int)(latency * toMs);
+        queue->histogram[bucket < INPUT_LATENCY_BUCKETS ? bucket : INPUT_LATENCY_BUCKETS - 1]++;
+    }
+}
+
+static double getLatencyPercentile(InputQueue *queue, double percentile)
+{
+    Uint64 target = (Uint64)(queue->measured * percentile);
+    Uint64 seen = 0;
+
+    for (int i = 0; i < INPUT_LATENCY_BUCKETS; i++)
+    {
+        seen += queue->histogram[i];
+        if (seen > target)
+            return i + 1;
+    }
+
+    return INPUT_LATENCY_BUCKETS;
+}
+
+void printInputLatencyStats(InputQueue *queue)
+{
+    Uint32 consumed = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    if (consumed == 0 && queue->dropped == 0)
+        return;
+
+    double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+    printf("Entrada: %u eventos, %llu descartados com a fila cheia; até o tick: média %.1f ms, pior %.1f ms\n",
+           consumed, (unsigned long long)queue->dropped,
+           consumed > 0 ? queue->consumedLatency * toMs / consumed : 0.0, queue->maxConsumedLatency * toMs);
+
+    if (queue->measured > 0)
+        printf("Entrada até a tela: média %.1f ms, p50 < %.0f ms, p95 < %.0f ms, pior %.1f ms (%llu eventos medidos)\n",
+               queue->totalLatency * toMs / queue->measured, getLatencyPercentile(queue, 0.5),
+               getLatencyPercentile(queue, 0.95), queue->maxLatency * toMs, (unsigned long long)queue->measured);
+}
@@ -0,0 +1,54 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef INPUT_H
+#define INPUT_H
+
+// Precisa ser potência de 2
+#define INPUT_QUEUE_CAPACITY 256
+
+// Faixas de 1 ms do histograma de latência; a última junta tudo acima
+#define INPUT_LATENCY_BUCKETS 100
+
+// Tecla pressionada ou solta, com o instante (SDL_GetPerformanceCounter) em que o SDL a recebeu
+typedef struct
+{
+    Uint64 timestamp;
+    Uint8 key; // um dos HELICOPTER_INPUT_*
+    bool pressed;
+} InputEvent;
+
+// Fila sem locks de um produtor (o laço de eventos, na thread principal) e um consumidor
+// (a simulação, antes de cada tick). Um evento continua no seu slot depois de consumido,
+// até ser sobrescrito, então a thread principal ainda consegue ler o instante dele
+// quando o tick que o aplicou chega na tela
+typedef struct
+{
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+    // só a simulação escreve em head, e só a thread principal em tail
+    Uint32 head;
+    Uint32 tail;
+
+    // Lado da simulação: teclas pressionadas no momento
+    Uint8 state;
+    Uint64 consumedLatency; // soma do tempo entre o evento e o tick que o aplicou
+    Uint64 maxConsumedLatency;
+
+    // Lado da thread principal: eventos já medidos até a apresentação
+    Uint32 presented;
+    Uint64 dropped;
+    Uint64 measured;
+    Uint64 totalLatency;
+    Uint64 maxLatency;
+    Uint32 histogram[INPUT_LATENCY_BUCKETS];
+} InputQueue;
+
+void initInputQueue(InputQueue *queue);
+bool pushInputEvent(InputQueue *queue, Uint8 key, bool pressed, Uint64 timestamp);
+Uint8 consumeInputEvents(InputQueue *queue, Uint64 now);
+Uint32 getConsumedInputEvents(InputQueue *queue);
+void recordInputLatency(InputQueue *queue, Uint32 consumed, Uint64 presentedAt);
+void printInputLatencyStats(InputQueue *queue);
+
+#endif /* INPUT_H */
@@ -0,0 +1,267 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "jobs.h"
+#include "trace.h"
+
+typedef struct
+{
+    JobPool *pool;
+    int index;
+} JobWorkerParams;
+
+static void initJobQueue(JobQueue *queue, int capacity)
+{
+    queue->jobs = (Job *)malloc(sizeof(Job) * capacity);
+    queue->capacity = capacity;
+    queue->top = 0;
+    queue->bottom = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+}
+
+static void destroyJobQueue(JobQueue *queue)
+{
+    free(queue->jobs);
+    pthread_mutex_destroy(&queue->lock);
+}
+
+static void pushJob(JobQueue *queue, Job job)
+{
+    pthread_mutex_lock(&queue->lock);
+
+    // a fila é um buffer circular que dobra de tamanho quando enche
+    if (queue->bottom - queue->top == queue->capacity)
+    {
+        Job *jobs = (Job *)malloc(sizeof(Job) * queue->capacity * 2);
+        for (int i = queue->top; i < queue->bottom; i++)
+            jobs[i - queue->top] = queue->jobs[i % queue->capacity];
+
+        free(queue->jobs);
+        queue->jobs = jobs;
+        queue->bottom -= queue->top;
+        queue->top = 0;
+        queue->capacity *= 2;
+    }
+
+    queue->jobs[queue->bottom % queue->capacity] = job;
+    queue->bottom++;
+
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// Quando a fila esvazia, top e bottom voltam pro começo. Sem isso os dois só cresceriam
+// (a fila só é reorganizada quando enche) e passariam do limite do int numa sessão longa
+static void rewindEmptyJobQueue(JobQueue *queue)
+{
+    if (queue->top == queue->bottom)
+    {
+        queue->top = 0;
+        queue->bottom = 0;
+    }
+}
+
+// O dono pega o job mais recente (ainda quente no cache)
+static bool popJob(JobQueue *queue, Job *job)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->bottom > queue->top)
+    {
+        queue->bottom--;
+        *job = queue->jobs[queue->bottom % queue->capacity];
+        found = true;
+        rewindEmptyJobQueue(queue);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+// Os outros roubam o job mais antigo
+static bool stealJob(JobQueue *queue, Job *job)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->bottom > queue->top)
+    {
+        *job = queue->jobs[queue->top % queue->capacity];
+        queue->top++;
+        found = true;
+        rewindEmptyJobQueue(queue);
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+// Procura um job na própria fila e, se estiver vazia, nas filas dos outros
+static bool takeJob(JobPool *pool, int index, Job *job)
+{
+    if (__atomic_load_n(&pool->queuedJobs, __ATOMIC_ACQUIRE) == 0)
+        return false;
+
+    if (popJob(&pool->queues[index], job))
+    {
+        __atomic_sub_fetch(&pool->queuedJobs, 1, __ATOMIC_ACQ_REL);
+        return true;
+    }
+
+    for (int i = 1; i < pool->numQueues; i++)
+    {
+        if (stealJob(&pool->queues[(index + i) % pool->numQueues], job))
+        {
+            __atomic_sub_fetch(&pool->queuedJobs, 1, __ATOMIC_ACQ_REL);
+            __atomic_add_fetch(&pool->stolenJobs, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void runJob(JobPool *pool, Job *job)
+{
+    Uint64 start = traceBegin();
+    job->function(job->arg);
+    traceEnd("job", "jobs", start);
+    __atomic_add_fetch(&pool->executedJobs, 1, __ATOMIC_RELAXED);
+
+    // o último job a terminar acorda quem está esperando em waitJobPool
+    if (__atomic_sub_fetch(&pool->pendingJobs, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->allDone);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+static void *runJobWorker(void *arg)
+{
+    JobWorkerParams *params = (JobWorkerParams *)arg;
+    JobPool *pool = params->pool;
+    int index = params->index;
+    free(params);
+
+    setTraceThreadName("worker %d", index);
+
+    while (1)
+    {
+        Job job;
+        if (takeJob(pool, index, &job))
+        {
+            runJob(pool, &job);
+            continue;
+        }
+
+        // sem trabalho: dorme até chegar um job novo, sem girar em falso
+        pthread_mutex_lock(&pool->lock);
+        while (__atomic_load_n(&pool->queuedJobs, __ATOMIC_ACQUIRE) == 0 && !pool->stopping)
+            pthread_cond_wait(&pool->workAvailable, &pool->lock);
+        bool stopping = pool->stopping;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (stopping)
+            break;
+    }
+
+    return NULL;
+}
+
+// Número de workers padrão: um por núcleo, descontando a thread que submete os jobs
+int getDefaultJobPoolWorkers()
+{
+    int cores = SDL_GetCPUCount();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void initJobPool(JobPool *pool, int numWorkers)
+{
+    pool->numWorkers = numWorkers;
+    pool->numQueues = numWorkers + 1;
+    pool->nextQueue = 0;
+    pool->queuedJobs = 0;
+    pool->pendingJobs = 0;
+    pool->stopping = false;
+    pool->executedJobs = 0;
+    pool->stolenJobs = 0;
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->workAvailable, NULL);
+    pthread_cond_init(&pool->allDone, NULL);
+
+    pool->queues = (JobQueue *)malloc(sizeof(JobQueue) * pool->numQueues);
+    for (int i = 0; i < pool->numQueues; i++)
+        initJobQueue(&pool->queues[i], 64);
+
+    pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * (numWorkers > 0 ? numWorkers : 1));
+    for (int i = 0; i < numWorkers; i++)
+    {
+        JobWorkerParams *params = (JobWorkerParams *)malloc(sizeof(JobWorkerParams));
+        params->pool = pool;
+        params->index = i;
+        pthread_create(&pool->threads[i], NULL, runJobWorker, params);
+    }
+}
+
+void destroyJobPool(JobPool *pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->numWorkers; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    for (int i = 0; i < pool->numQueues; i++)
+        destroyJobQueue(&pool->queues[i]);
+
+    free(pool->queues);
+    free(pool->threads);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->workAvailable);
+    pthread_cond_destroy(&pool->allDone);
+}
+
+// Distribui os jobs entre as filas em rodízio; quem estiver livre rouba o resto.
+// Deve ser chamada sempre pela mesma thread, a que depois chama waitJobPool
+void submitJob(JobPool *pool, JobFunction function, void *arg)
+{
+    Job job = {function, arg};
+
+    __atomic_add_fetch(&pool->pendingJobs, 1, __ATOMIC_ACQ_REL);
+    pushJob(&pool->queues[pool->nextQueue], job);
+    pool->nextQueue = (pool->nextQueue + 1) % pool->numQueues;
+    __atomic_add_fetch(&pool->queuedJobs, 1, __ATOMIC_ACQ_REL);
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->workAvailable);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Executa jobs junto com os workers até que todos os submetidos terminem
+void waitJobPool(JobPool *pool)
+{
+    Job job;
+    while (takeJob(pool, pool->numQueues - 1, &job))
+        runJob(pool, &job);
+
+    // espera os jobs que os workers ainda estão rodando
+    Uint64 start = traceBegin();
+    pthread_mutex_lock(&pool->lock);
+    while (__atomic_load_n(&pool->pendingJobs, __ATOMIC_ACQUIRE) > 0)
+        pthread_cond_wait(&pool->allDone, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    traceEnd("espera dos workers", "jobs", start);
+}
+
+void printJobPoolStats(JobPool *pool)
+{
+    printf("Pool de jobs: %d workers + thread principal, %llu jobs executados, %llu roubados\n",
+           pool->numWorkers,
+           (unsigned long long)pool->executedJobs,
+           (unsigned long long)pool->stolenJobs);
+}
@@ -0,0 +1,57 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifndef JOBS_H
+#define JOBS_H
+
+typedef void (*JobFunction)(void *arg);
+
+typedef struct
+{
+    JobFunction function;
+    void *arg;
+} Job;
+
+// Fila de dois lados de cada worker: o dono empilha e desempilha pelo fim,
+// os outros workers roubam pelo começo
+typedef struct
+{
+    Job *jobs;
+    int capacity;
+    int top;
+    int bottom;
+    pthread_mutex_t lock;
+} JobQueue;
+
+// Pool de tamanho fixo com roubo de trabalho. A thread que chama waitJobPool
+// também executa jobs, então o pool usa um worker a menos que o número de núcleos
+typedef struct
+{
+    pthread_t *threads;
+    int numWorkers;
+    JobQueue *queues; // numWorkers + 1; a última é a da thread que submete
+    int numQueues;
+    int nextQueue;
+
+    int queuedJobs;  // jobs nas filas, ainda não iniciados
+    int pendingJobs; // jobs submetidos e ainda não terminados
+    bool stopping;
+    pthread_mutex_t lock;
+    pthread_cond_t workAvailable;
+    pthread_cond_t allDone;
+
+    // estatísticas
+    Uint64 executedJobs;
+    Uint64 stolenJobs;
+} JobPool;
+
+void initJobPool(JobPool *pool, int numWorkers);
+void destroyJobPool(JobPool *pool);
+void submitJob(JobPool *pool, JobFunction function, void *arg);
+void waitJobPool(JobPool *pool);
+int getDefaultJobPoolWorkers();
+void printJobPoolStats(JobPool *pool);
+
+#endif /* JOBS_H */
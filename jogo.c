@@ -1,114 +1,123 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_image.h>
 #include <stdio.h>
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include <time.h>
-#include <semaphore.h>
 #include "helicopter.h"
 #include "cannon.h"
 #include "scenario.h"
-
-// Constantes
-const int SCREEN_WIDTH = 1100;
-const int SCREEN_HEIGHT = 700;
-const int GROUND_HEIGHT = 100;
-const int BUILDING_WIDTH = 200;
-const int BUILDING_HEIGHT = 300;
-const int BRIDGE_WIDTH = 150;
-const int BRIDGE_HEIGHT = GROUND_HEIGHT;
-const int CANNON_WIDTH = 100;
-const int CANNON_HEIGHT = 50;
-const int HELICOPTER_WIDTH = 150;
-const int HELICOPTER_HEIGHT = 75;
-const int MISSILE_WIDTH = 5;
-const int MISSILE_HEIGHT = 15;
-const int CANNON_SPEED = 2;
-const int HELICOPTER_SPEED = 3;
-const int MISSILE_SPEED = 5;
-const int NUM_HOSTAGES = 10;
-const int HOSTAGE_WIDTH = 15;
-const int HOSTAGE_HEIGHT = 30;
-const int MARGIN_BETWEEN_HOSTAGES = 5;
-const int EXPLOSION_SIZE = 75;
-
-int MIN_COOLDOWN_TIME = 1500;
-int MAX_COOLDOWN_TIME = 4500;
-int AMMUNITION = 10;
-int RELOAD_TIME_FOR_EACH_MISSILE = 500; // milisegundos
-
-pthread_mutex_t bridgeMutex = PTHREAD_MUTEX_INITIALIZER;
-
-int currentHostages = NUM_HOSTAGES;
-int rescuedHostages = 0;
-
-bool destroyed = false;
-bool gameover = false;
-
-ScenarioElementInfo background;
-ScenarioElementInfo groundInfo;
-ScenarioElementInfo bridgeInfo;
-ScenarioElementInfo leftBuilding;
-ScenarioElementInfo rightBuilding;
+#include "missile.h"
+#include "assets.h"
+#include "headless.h"
+#include "broadphase.h"
+#include "simulation.h"
+#include "jobs.h"
+#include "snapshot.h"
+#include "pacing.h"
+#include "bridge.h"
+#include "depot.h"
+#include "trace.h"
+#include "batch.h"
+#include "screen.h"
+#include "sessions.h"
+#include "recording.h"
+#include "spectator.h"
+#include "rewind.h"
+#include "savestate.h"
+
+extern int SCREEN_WIDTH;
+extern int SCREEN_HEIGHT;
+extern int NUM_HOSTAGES;
+extern int EXPLOSION_FRAMES;
+extern int BASE_SIMULATION_TICK_TIME;
+extern int DEFAULT_TARGET_FPS;
+extern AssetAtlas assets;
 
 // Função pra renderizar os objetos
-// Isso não pode ser concorrente porque a tela que o usuário vê é uma zona de exclusão mútua
-void render(SDL_Renderer *renderer, CannonInfo *cannon1Info, CannonInfo *cannon2Info, HelicopterInfo *helicopterInfo)
+// Desenha só a partir do último snapshot publicado pela simulação, interpolando as posições
+// entre os dois últimos ticks com o fator alpha (0 = tick anterior, 1 = último tick).
+// Os objetos só são acumulados no lote, que é enviado de uma vez antes de apresentar o quadro.
+// Retorna true se o jogo acabou
+bool render(Screen *screen, RenderBatch *batch, SimulationSnapshot *snapshot, float alpha)
 {
-    // Limpa a tela
-    SDL_RenderClear(renderer);
-    
-    drawScenarioElement(renderer, &background);
-    drawScenarioElement(renderer, &leftBuilding);
-    drawScenarioElement(renderer, &rightBuilding);
-    drawScenarioElement(renderer, &groundInfo);
-    drawScenarioElement(renderer, &bridgeInfo);
-
-    drawCannon(cannon1Info, renderer);
-    drawCannon(cannon2Info, renderer);
-
-    // Desenha os mísseis do canhão 1
-    for (int i = 0; i < cannon1Info->numActiveMissiles; i++)
+    bool gameover = false;
+    Uint64 frameStart = traceBegin();
+    Uint64 start = frameStart;
+
+    // Copia o cenário fixo (ou só as regiões que os objetos ocuparam no quadro anterior)
+    beginScreenFrame(screen, batch);
+    traceEnd("desenha cenário", "quadro", start);
+
+    start = traceBegin();
+    for (int i = 0; i < snapshot->numCannons; i++)
     {
-        if (cannon1Info->missiles[i].active)
-        {
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 0);
-            SDL_RenderFillRect(renderer, &cannon1Info->missiles[i].rect);
-        }
+        CannonInfo cannon = snapshot->cannons[i];
+        cannon.rect = interpolateRect(snapshot->previousCannonRects[i], cannon.rect, alpha);
+        drawCannon(&cannon, snapshot->maxAmmunition, batch);
     }
+    traceEnd("desenha canhões", "quadro", start);
 
-    // Desenha os mísseis do canhão 2
-    for (int i = 0; i < cannon2Info->numActiveMissiles; i++)
+    // Desenha os mísseis de todos os canhões
+    start = traceBegin();
+    drawSnapshotMissiles(snapshot, batch, alpha);
+    traceEnd("desenha mísseis", "quadro", start);
+
+    start = traceBegin();
+    drawHostages(batch, snapshot->currentHostages, snapshot->rescuedHostages);
+    traceEnd("desenha reféns", "quadro", start);
+
+    start = traceBegin();
+    // helicópteros destruídos deixam de ser desenhados
+    for (int i = 1; i < snapshot->numHelicopters; i++)
     {
-        if (cannon2Info->missiles[i].active)
-        {
-            SDL_SetRenderDrawColor(renderer, 255, 0, 0, 0);
-            SDL_RenderFillRect(renderer, &cannon2Info->missiles[i].rect);
-        }
+        HelicopterInfo helicopter = snapshot->helicopters[i];
+        helicopter.rect = interpolateRect(snapshot->previousHelicopterRects[i], helicopter.rect, alpha);
+        if (!helicopter.destroyed)
+            drawHelicopter(&helicopter, batch);
     }
 
-    drawHostages(renderer, currentHostages, rescuedHostages);
-
-    if (destroyed) 
+    // o jogo acaba quando o helicóptero do jogador (o primeiro) é destruído
+    HelicopterInfo helicopterInfo = snapshot->helicopters[0];
+    helicopterInfo.rect = interpolateRect(snapshot->previousHelicopterRects[0], helicopterInfo.rect, alpha);
+    if (helicopterInfo.destroyed) 
     {
-        drawExplosion(
-            renderer,
-            helicopterInfo->rect.x + (helicopterInfo->rect.w / 2),
-            helicopterInfo->rect.y + (helicopterInfo->rect.h / 2)
-        );
+        // a explosão apresenta os próprios quadros, por cima do que já está no lote
+        for (int frame = 0; frame < EXPLOSION_FRAMES; frame++)
+        {
+            drawExplosion(
+                batch,
+                helicopterInfo.rect.x + (helicopterInfo.rect.w / 2),
+                helicopterInfo.rect.y + (helicopterInfo.rect.h / 2),
+                frame
+            );
+            flushRenderBatch(batch);
+            presentFullScreen(screen);
+            SDL_Delay(100);
+        }
         gameover = true;
     }
-    else drawHelicopter(helicopterInfo, renderer);
+    else drawHelicopter(&helicopterInfo, batch);
 
-    if (rescuedHostages == NUM_HOSTAGES)
+    if (snapshot->rescuedHostages == NUM_HOSTAGES)
     {
         gameover = true;
     }
+    traceEnd("desenha helicópteros", "quadro", start);
+
+    start = traceBegin();
+    endRenderBatchFrame(batch);
+    traceEnd("SDL_RenderGeometry", "quadro", start);
 
     // Atualiza a tela
-    SDL_RenderPresent(renderer);
+    start = traceBegin();
+    presentScreenFrame(screen, batch);
+    traceEnd("SDL_RenderPresent", "quadro", start);
+
+    traceEnd("render", "quadro", frameStart);
+    return gameover;
 }
 
 int getDifficultyChoice() {
@@ -137,23 +146,13 @@ int getDifficultyChoice() {
     return choice;
 }
 
-int main(int argc, char *argv[])
+// Abre a janela e roda o jogo: a simulação avança na sua própria thread, em ticks fixos,
+// enquanto a thread principal trata os eventos e desenha no ritmo escolhido.
+// targetFps < 0 usa o vsync do monitor; 0 desenha sem limite
+int runWindowed(Simulation *simulation, int targetFps, bool dirtyRects)
 {
-    int difficulty = getDifficultyChoice();
-
-    AMMUNITION = AMMUNITION * (0.5 * difficulty + 0.5);
-    RELOAD_TIME_FOR_EACH_MISSILE = RELOAD_TIME_FOR_EACH_MISSILE / difficulty;
-    MIN_COOLDOWN_TIME = MIN_COOLDOWN_TIME / difficulty;
-    MAX_COOLDOWN_TIME = MAX_COOLDOWN_TIME / difficulty;
-
-    // Inicializa o SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0)
-    {
-        printf("Problema ao inicializar SDL. Erro: %s\n", SDL_GetError());
-        return 1;
-    }
-
-    SDL_Init(SDL_INIT_VIDEO);
+    Uint64 startupBegin = SDL_GetPerformanceCounter();
+    bool firstFrame = true;
 
     // Cria uma janela SDL
     SDL_Window *window = SDL_CreateWindow("Jogo Concorrente", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
@@ -163,65 +162,73 @@ int main(int argc, char *argv[])
         return 1;
     }
 
-    // Cria um renderizador SDL
-    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    // Cria um renderizador SDL. Com regiões sujas, é o renderizador por software desenhando na janela
+    Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+    if (targetFps < 0)
+        rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+    SDL_Renderer *renderer = createScreenRenderer(window, rendererFlags, dirtyRects);
     if (renderer == NULL)
     {
         printf("Renderizador do SDL não pôde ser criado. Erro: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        return 1;
+    }
+
+    // Carrega o atlas já decodificado do pacote gerado pelo tools/bake_assets
+    if (!loadAssets(renderer, &assets))
+    {
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        return 1;
+    }
+    printAssetLoadStats(&assets);
+
+    // Se o renderizador não tiver vsync, limita a taxa de quadros dormindo
+    bool vsync = false;
+    if (targetFps < 0)
+    {
+        SDL_RendererInfo rendererInfo;
+        if (SDL_GetRendererInfo(renderer, &rendererInfo) == 0 && (rendererInfo.flags & SDL_RENDERER_PRESENTVSYNC))
+        {
+            vsync = true;
+            targetFps = 0;
+        }
+        else
+        {
+            printf("Renderizador sem vsync, limitando a %d fps\n", DEFAULT_TARGET_FPS);
+            targetFps = DEFAULT_TARGET_FPS;
+        }
+    }
+
+    FramePacer pacer;
+    initFramePacer(&pacer, targetFps, vsync);
+
+    // Um quad por míssil que cabe no snapshot, mais os sprites do cenário, reféns, canhões e helicópteros,
+    // pra que o quadro inteiro sempre saia em uma única chamada de desenho
+    RenderBatch batch;
+    int batchCapacity = simulation->snapshots.buffers[0].missileCapacity + 5 + NUM_HOSTAGES + simulation->numCannons + simulation->numHelicopters;
+    if (!initRenderBatch(&batch, renderer, &assets, batchCapacity))
+    {
+        destroyAssets(&assets);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
         return 1;
     }
 
-    // Cria os elementos do cenário
-    background = createScenarioElement(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
-    groundInfo = createScenarioElement(0, SCREEN_HEIGHT - GROUND_HEIGHT, SCREEN_WIDTH, GROUND_HEIGHT);
-    bridgeInfo = createScenarioElement(BUILDING_WIDTH, SCREEN_HEIGHT - BRIDGE_HEIGHT, BRIDGE_WIDTH, BRIDGE_HEIGHT);
-    leftBuilding = createScenarioElement(0, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT, BUILDING_WIDTH, BUILDING_HEIGHT);
-    rightBuilding = createScenarioElement(SCREEN_WIDTH - BUILDING_WIDTH, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT, BUILDING_WIDTH, BUILDING_HEIGHT);
-
-    loadScenarioSpritesheet(renderer, &background, "sprites/background_spritesheet.png");
-    loadScenarioSpritesheet(renderer, &leftBuilding, "sprites/left_building_spritesheet.png");
-    loadScenarioSpritesheet(renderer, &rightBuilding, "sprites/right_building_spritesheet.png");
-    loadScenarioSpritesheet(renderer, &groundInfo, "sprites/ground_spritesheet.png");
-    loadScenarioSpritesheet(renderer, &bridgeInfo, "sprites/bridge_spritesheet.png");
-
-    // Cria os canhões
-    CannonInfo cannon1Info = createCannon(BUILDING_WIDTH + BRIDGE_WIDTH + CANNON_WIDTH * 2, SCREEN_HEIGHT - BRIDGE_HEIGHT - CANNON_HEIGHT, CANNON_WIDTH, CANNON_HEIGHT, 0);
-    CannonInfo cannon2Info = createCannon(BUILDING_WIDTH + BRIDGE_WIDTH + CANNON_WIDTH, SCREEN_HEIGHT - BRIDGE_HEIGHT - CANNON_HEIGHT, CANNON_WIDTH, CANNON_HEIGHT, 0);
-    
-    loadCannonSprite(&cannon1Info, renderer);
-    loadCannonSprite(&cannon2Info, renderer);
-
-    // Inicializa o array de colisões para o helicóptero
-    SDL_Rect **rectArray = (SDL_Rect **)malloc(sizeof(SDL_Rect *) * 5);
-
-    rectArray[0] = &cannon1Info.rect;
-    rectArray[1] = &cannon2Info.rect;
-    rectArray[2] = &groundInfo.rect;
-    rectArray[3] = &leftBuilding.rect;
-    rectArray[4] = &rightBuilding.rect;
-
-    HelicopterInfo helicopterInfo = createHelicopter(SCREEN_WIDTH - BUILDING_WIDTH, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT - HELICOPTER_HEIGHT * 1.5, HELICOPTER_WIDTH, HELICOPTER_HEIGHT, HELICOPTER_SPEED, rectArray);
-    loadHelicopterSprite(&helicopterInfo, renderer);
-   
-    MoveCannonThreadParams paramsCannon1;
-    paramsCannon1.helicopterInfo = &helicopterInfo;
-    paramsCannon1.cannonInfo = &cannon1Info;
-
-    MoveCannonThreadParams paramsCannon2;
-    paramsCannon2.helicopterInfo = &helicopterInfo;
-    paramsCannon2.cannonInfo = &cannon2Info;
-
-    // Inicializa as threads
-    pthread_t thread_cannon1, thread_cannon2, thread_helicopter, thread_reload_cannon1, thread_reload_cannon2;
-    pthread_create(&thread_cannon1, NULL, moveCannon, &paramsCannon1);                    // thread do canhão 1
-    pthread_create(&thread_cannon2, NULL, moveCannon, &paramsCannon2);                    // thread do canhão 2
-    pthread_create(&thread_helicopter, NULL, moveHelicopter, &helicopterInfo);            // thread do helicóptero
-    pthread_create(&thread_reload_cannon1, NULL, reloadCannonAmmunition, &paramsCannon1); // thread do depósito do canhão 1
-    pthread_create(&thread_reload_cannon2, NULL, reloadCannonAmmunition, &paramsCannon2); // thread do depósito do canhão 2
-
-    srand(time(NULL)); // Seed pra gerar números aleatórios usados no cálculo do ângulo do míssil
-    
+    // Compõe o cenário fixo uma única vez
+    Scenario *scenario = &simulation->scenario;
+    ScenarioElementInfo *scenarioElements[] = {&scenario->background, &scenario->leftBuilding, &scenario->rightBuilding, &scenario->ground, &scenario->bridge};
+    Screen screen;
+    initScreen(&screen, window, renderer, dirtyRects, scenarioElements, 5);
+    buildStaticLayer(&screen, &batch);
+
+    // Inicializa a thread da simulação
+    pthread_t thread_simulation;
+    pthread_create(&thread_simulation, NULL, runSimulation, simulation);
+
     int quit = 0;
+    bool gameover = false;
+    int rescuedHostages = 0;
     SDL_Event e;
 
     while (!quit)
@@ -233,11 +240,57 @@ int main(int argc, char *argv[])
             {
                 quit = 1;
             }
+            else if (e.type == SDL_KEYDOWN && e.key.keysym.scancode == SDL_SCANCODE_BACKSPACE && simulation->rewind != NULL)
+            {
+                // a simulação volta alguns segundos antes do próximo tick, uma vez por tecla
+                __atomic_add_fetch(&simulation->rewindRequests, 1, __ATOMIC_RELEASE);
+            }
+            else if ((e.type == SDL_KEYDOWN || e.type == SDL_KEYUP) && !e.key.repeat)
+            {
+                // as teclas do helicóptero vão pra simulação pela fila de entrada, com o instante
+                // em que o SDL recebeu o evento (e não o de agora, que inclui a espera pelo quadro)
+                Uint8 key = getHelicopterKeyInput(e.key.keysym.scancode);
+                if (key != 0)
+                {
+                    Uint64 age = (Uint64)(SDL_GetTicks() - e.key.timestamp) * SDL_GetPerformanceFrequency() / 1000;
+                    pushInputEvent(&simulation->input, key, e.type == SDL_KEYDOWN, SDL_GetPerformanceCounter() - age);
+                }
+            }
+        }
+
+        // o replay em tempo real para sozinho quando a gravação acaba
+        if (!simulation->running)
+        {
+            printf("Fim da gravação\n");
+            quit = 1;
         }
 
         if (!gameover) {
             // Chama a função que renderiza o jogo na tela
-            render(renderer, &cannon1Info, &cannon2Info, &helicopterInfo);
+            SimulationSnapshot *snapshot = acquireLatestSnapshot(&simulation->snapshots);
+            gameover = render(&screen, &batch, snapshot, getSnapshotInterpolation(snapshot, SDL_GetPerformanceCounter()));
+            rescuedHostages = snapshot->rescuedHostages;
+            // com o retrocesso, o helicóptero destruído volta alguns segundos em vez de acabar
+            // o jogo; espera o snapshot que já inclui o pedido antes do próximo quadro.
+            // Só acaba se não houver estado guardado de antes da destruição
+            if (gameover && simulation->rewind != NULL && rescuedHostages != NUM_HOSTAGES)
+            {
+                Uint32 request = __atomic_add_fetch(&simulation->rewindRequests, 1, __ATOMIC_RELEASE);
+                while ((Sint32)(snapshot->rewindsDone - request) < 0 && simulation->running)
+                {
+                    SDL_Delay(1);
+                    snapshot = acquireLatestSnapshot(&simulation->snapshots);
+                }
+                gameover = snapshot->helicopters[0].destroyed;
+            }
+            recordInputLatency(&simulation->input, snapshot->inputsConsumed, SDL_GetPerformanceCounter());
+            if (firstFrame)
+            {
+                printf("Primeiro quadro apresentado %.1f ms depois de abrir a janela\n",
+                       (SDL_GetPerformanceCounter() - startupBegin) * 1000.0 / SDL_GetPerformanceFrequency());
+                firstFrame = false;
+            }
+            waitForNextFrame(&pacer);
         }
         else 
         {
@@ -246,27 +299,322 @@ int main(int argc, char *argv[])
             quit = 1;
         };
     }
-    
-    free(cannon1Info.missiles);
-    free(cannon2Info.missiles);
-    free(helicopterInfo.fixed_collision_rects);
-    free(helicopterInfo.missile_collision_rects);
-
-    // Destrói as threads
-    pthread_cancel(thread_cannon1);
-    pthread_cancel(thread_cannon2);
-    pthread_cancel(thread_helicopter);
-    pthread_cancel(thread_reload_cannon1);
-    pthread_cancel(thread_reload_cannon2);
-
-    sem_destroy(&cannon1Info.ammunition_semaphore_empty);
-    sem_destroy(&cannon2Info.ammunition_semaphore_empty);
-    sem_destroy(&cannon1Info.ammunition_semaphore_full);
-    sem_destroy(&cannon2Info.ammunition_semaphore_full);
 
+    // Para a thread da simulação
+    simulation->running = false;
+    pthread_join(thread_simulation, NULL);
+
+    printFramePacerStats(&pacer);
+    printSnapshotTripleBufferStats(&simulation->snapshots);
+    printRenderBatchStats(&batch);
+    printScreenStats(&screen);
+    printInputLatencyStats(&simulation->input);
+
+    destroyScreen(&screen);
+    destroyRenderBatch(&batch);
+    destroyAssets(&assets);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
-    SDL_Quit();
 
     return 0;
 }
+
+int main(int argc, char *argv[])
+{
+    bool headless = false;
+    bool dirtyRects = false;
+    int numWorkers = -1;
+    int targetFps = -1;
+    int numSessions = 0;
+    const char *tracePath = NULL;
+    HeadlessConfig headlessConfig = {100000, NULL};
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    bool realtime = false;
+    const char *spectatePath = NULL;
+    const char *saveStatePath = NULL;
+    const char *loadStatePath = NULL;
+    int rewindSeconds = 0;
+
+    // Opções da sessão; depotProducers e depotCapacity negativos usam os valores padrão
+    SessionConfig config = {time(NULL), 0, 2, 1, 6, -1, -1, BASE_SIMULATION_TICK_TIME};
+
+    // Lê as opções da linha de comando
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+            headlessConfig.ticks = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc)
+            headlessConfig.scriptPath = argv[++i];
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            config.seed = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc)
+            config.difficulty = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cannons") == 0 && i + 1 < argc)
+            config.numCannons = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--helicopters") == 0 && i + 1 < argc)
+            config.numHelicopters = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            numWorkers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bridge-segments") == 0 && i + 1 < argc)
+            config.bridgeSegments = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--depot-producers") == 0 && i + 1 < argc)
+        {
+            // sem produtores, os canhões esperariam no depósito pra sempre
+            config.depotProducers = atoi(argv[++i]);
+            if (config.depotProducers < 1)
+            {
+                printf("--depot-producers precisa ser 1 ou mais (recebido: %s)\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--depot-capacity") == 0 && i + 1 < argc)
+            config.depotCapacity = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            i++;
+            targetFps = strcmp(argv[i], "vsync") == 0 ? -1 : atoi(argv[i]);
+        }
+        else if (strcmp(argv[i], "--dirty-rects") == 0)
+            dirtyRects = true;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (strcmp(argv[i], "--realtime") == 0)
+            realtime = true;
+        else if (strcmp(argv[i], "--tick-ms") == 0 && i + 1 < argc)
+            config.tickTime = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc)
+            numSessions = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--spectate") == 0 && i + 1 < argc)
+            spectatePath = argv[++i];
+        else if (strcmp(argv[i], "--rewind") == 0 && i + 1 < argc)
+            rewindSeconds = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--save-state") == 0 && i + 1 < argc)
+            saveStatePath = argv[++i];
+        else if (strcmp(argv[i], "--load-state") == 0 && i + 1 < argc)
+            loadStatePath = argv[++i];
+        else
+        {
+            printf("Uso: %s [--difficulty 1-3] [--cannons N] [--helicopters N] [--workers N]\n", argv[0]);
+            printf("          [--bridge-segments N] [--depot-producers N (1 ou mais)] [--depot-capacity N]\n");
+            printf("          [--fps vsync|N (0 = sem limite)] [--dirty-rects] [--trace arquivo.json]\n");
+            printf("          [--headless [--ticks N] [--script arquivo] [--seed N]]\n");
+            printf("          [--record arquivo] [--replay arquivo [--realtime]] [--tick-ms N]\n");
+            printf("          [--sessions N] [--spectate socket]\n");
+            printf("          [--rewind segundos] [--save-state arquivo] [--load-state arquivo]\n");
+            return 1;
+        }
+    }
+
+    // O replay usa as opções da sessão gravada e, sem --realtime, roda sem janela o mais rápido possível
+    InputRecording replay;
+    if (replayPath != NULL)
+    {
+        if (!loadInputRecording(&replay, replayPath))
+            return 1;
+
+        config = replay.config;
+        headless = !realtime;
+        headlessConfig.ticks = replay.numTicks;
+    }
+
+    // A gravação guarda os comandos a partir do tick 0, sem voltas no tempo
+    if (recordPath != NULL && (rewindSeconds > 0 || loadStatePath != NULL))
+    {
+        printf("--record não pode ser usado junto com --rewind ou --load-state\n");
+        return 1;
+    }
+
+    // Um estado salvo traz as opções da sessão, a não ser que venha junto com um replay,
+    // que precisa ter as mesmas
+    SaveState loadedState;
+    if (loadStatePath != NULL)
+    {
+        if (!loadSaveStateFile(&loadedState, loadStatePath))
+            return 1;
+        if (replayPath == NULL)
+            config = ((SaveStateHeader *)loadedState.data)->config;
+    }
+
+    // Com --sessions, roda várias sessões sem janela em paralelo no pool e só mostra o agregado.
+    // Sem --difficulty, as sessões se alternam entre as três dificuldades
+    if (numSessions > 0)
+    {
+        if (SDL_Init(0) < 0)
+        {
+            printf("Problema ao inicializar SDL. Erro: %s\n", SDL_GetError());
+            return 1;
+        }
+        initTracing(tracePath);
+        setTraceThreadName("principal", 0);
+
+        JobPool jobPool;
+        initJobPool(&jobPool, numWorkers >= 0 ? numWorkers : getDefaultJobPoolWorkers());
+
+        SessionBatchConfig batchConfig = {config, numSessions, headlessConfig.ticks, headlessConfig.scriptPath,
+                                          config.difficulty < 1 || config.difficulty > 3};
+        int result = runSessionBatch(&batchConfig, &jobPool);
+
+        printJobPoolStats(&jobPool);
+        destroyJobPool(&jobPool);
+        writeTrace();
+        SDL_Quit();
+        return result;
+    }
+
+    if (config.difficulty < 1 || config.difficulty > 3)
+        config.difficulty = getDifficultyChoice();
+
+    // Inicializa o SDL (sem vídeo no modo headless)
+    if (SDL_Init(headless ? 0 : SDL_INIT_VIDEO) < 0)
+    {
+        printf("Problema ao inicializar SDL. Erro: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    // Com --trace, grava a linha do tempo de cada thread pra abrir no chrome://tracing ou no Perfetto
+    initTracing(tracePath);
+    setTraceThreadName("principal", 0);
+
+    // Pool de threads de tamanho fixo, que atualiza canhões e helicópteros como jobs
+    JobPool jobPool;
+    initJobPool(&jobPool, numWorkers >= 0 ? numWorkers : getDefaultJobPoolWorkers());
+
+    // Cria a sessão: cenário, ponte, depósito, mísseis, canhões e helicópteros.
+    // A semente define os números aleatórios de cada canhão
+    Simulation simulation;
+    if (!initSimulation(&simulation, &config, &jobPool))
+    {
+        destroyJobPool(&jobPool);
+        SDL_Quit();
+        return 1;
+    }
+
+    // Grava os comandos de cada tick pra repetir a sessão depois com --replay
+    InputRecording recording;
+    if (recordPath != NULL)
+    {
+        initInputRecording(&recording, &simulation.config);
+        simulation.recorder = &recording;
+    }
+    if (replayPath != NULL)
+        simulation.replay = &replay;
+    // O retrocesso no headless confere no fim se a sessão se repete igual, então também
+    // precisa de uma simulação reproduzível
+    simulation.deterministic = recordPath != NULL || replayPath != NULL || (headless && rewindSeconds > 0);
+
+    // Continua a sessão do estado salvo; o replay segue de onde ele parou
+    if (loadStatePath != NULL)
+    {
+        bool restored = restoreSimulationState(&simulation, &loadedState);
+        freeSaveState(&loadedState);
+        if (!restored)
+        {
+            destroySimulation(&simulation);
+            destroyJobPool(&jobPool);
+            SDL_Quit();
+            return 1;
+        }
+        printf("Sessão restaurada no tick %d\n", simulation.tick);
+        if (replayPath != NULL)
+            headlessConfig.ticks = SDL_max(replay.numTicks - simulation.tick, 0);
+    }
+
+    // Guarda os estados dos últimos segundos pra voltar neles (Backspace no modo com janela)
+    RewindBuffer rewind;
+    if (rewindSeconds != 0)
+    {
+        if (!initRewindBuffer(&rewind, &simulation, rewindSeconds, 1))
+        {
+            destroySimulation(&simulation);
+            destroyJobPool(&jobPool);
+            SDL_Quit();
+            return 1;
+        }
+        simulation.rewind = &rewind;
+    }
+
+    // Transmite a sessão pra quem se conectar no socket (tools/spectator_viewer)
+    SpectatorPublisher spectators;
+    if (spectatePath != NULL)
+    {
+        if (!initSpectatorPublisher(&spectators, spectatePath, &simulation))
+        {
+            destroySimulation(&simulation);
+            destroyJobPool(&jobPool);
+            SDL_Quit();
+            return 1;
+        }
+        simulation.spectators = &spectators;
+    }
+
+    int result = 0;
+
+    if (headless)
+    {
+        // Roda a simulação sem janela em um relógio virtual e sai
+        result = runHeadless(&headlessConfig, &simulation);
+    }
+    else
+    {
+        result = runWindowed(&simulation, targetFps, dirtyRects);
+    }
+
+    printSimulationStats(&simulation);
+    printMissileSystemStats(&simulation.missileSystem);
+    printJobPoolStats(&jobPool);
+
+    if (spectatePath != NULL)
+    {
+        printSpectatorPublisherStats(&spectators);
+        destroySpectatorPublisher(&spectators);
+    }
+
+    if (rewindSeconds > 0)
+    {
+        printRewindBufferStats(&rewind, &simulation);
+        destroyRewindBuffer(&rewind);
+        simulation.rewind = NULL;
+    }
+
+    if (saveStatePath != NULL)
+    {
+        SaveState state;
+        if (!initSaveState(&state, getMaxSaveStateSize(&simulation)))
+            result = 1;
+        else
+        {
+            saveSimulationState(&simulation, &state);
+            if (!writeSaveStateFile(&state, saveStatePath))
+                result = 1;
+        }
+        freeSaveState(&state);
+    }
+
+    if (recordPath != NULL)
+    {
+        if (!saveInputRecording(&recording, recordPath, hashSimulationState(&simulation)))
+            result = 1;
+        freeInputRecording(&recording);
+    }
+    if (replayPath != NULL)
+    {
+        // um replay interrompido antes do fim não tem como bater com a gravação
+        if (simulation.tick == replay.numTicks && !verifyInputRecording(&replay, hashSimulationState(&simulation)))
+            result = 1;
+        freeInputRecording(&replay);
+    }
+
+    destroySimulation(&simulation);
+    destroyJobPool(&jobPool);
+    writeTrace();
+    SDL_Quit();
+
+    return result;
+}
@@ -0,0 +1,559 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "missile.h"
+#include "trace.h"
+
+extern int SCREEN_WIDTH;
+extern int SCREEN_HEIGHT;
+extern int MISSILE_WIDTH;
+extern int MISSILE_HEIGHT;
+
+// Vetor unitário (cos, sin) de cada ângulo inteiro de disparo, em ponto fixo Q16.
+// Gerado offline, assim as trajetórias não dependem da libm de cada máquina
+static const int missileDirections[MISSILE_NUM_ANGLES][2] = {
+    {65536, 0}, {65526, 1144}, {65496, 2287}, {65446, 3430},
+    {65376, 4572}, {65287, 5712}, {65177, 6850}, {65048, 7987},
+    {64898, 9121}, {64729, 10252}, {64540, 11380}, {64332, 12505},
+    {64104, 13626}, {63856, 14742}, {63589, 15855}, {63303, 16962},
+    {62997, 18064}, {62672, 19161}, {62328, 20252}, {61966, 21336},
+    {61584, 22415}, {61183, 23486}, {60764, 24550}, {60326, 25607},
+    {59870, 26656}, {59396, 27697}, {58903, 28729}, {58393, 29753},
+    {57865, 30767}, {57319, 31772}, {56756, 32768}, {56175, 33754},
+    {55578, 34729}, {54963, 35693}, {54332, 36647}, {53684, 37590},
+    {53020, 38521}, {52339, 39441}, {51643, 40348}, {50931, 41243},
+    {50203, 42126}, {49461, 42995}, {48703, 43852}, {47930, 44695},
+    {47143, 45525}, {46341, 46341}, {45525, 47143}, {44695, 47930},
+    {43852, 48703}, {42995, 49461}, {42126, 50203}, {41243, 50931},
+    {40348, 51643}, {39441, 52339}, {38521, 53020}, {37590, 53684},
+    {36647, 54332}, {35693, 54963}, {34729, 55578}, {33754, 56175},
+    {32768, 56756}, {31772, 57319}, {30767, 57865}, {29753, 58393},
+    {28729, 58903}, {27697, 59396}, {26656, 59870}, {25607, 60326},
+    {24550, 60764}, {23486, 61183}, {22415, 61584}, {21336, 61966},
+    {20252, 62328}, {19161, 62672}, {18064, 62997}, {16962, 63303},
+    {15855, 63589}, {14742, 63856}, {13626, 64104}, {12505, 64332},
+    {11380, 64540}, {10252, 64729}, {9121, 64898}, {7987, 65048},
+    {6850, 65177}, {5712, 65287}, {4572, 65376}, {3430, 65446},
+    {2287, 65496}, {1144, 65526}, {0, 65536}, {-1144, 65526},
+    {-2287, 65496}, {-3430, 65446}, {-4572, 65376}, {-5712, 65287},
+    {-6850, 65177}, {-7987, 65048}, {-9121, 64898}, {-10252, 64729},
+    {-11380, 64540}, {-12505, 64332}, {-13626, 64104}, {-14742, 63856},
+    {-15855, 63589}, {-16962, 63303}, {-18064, 62997}, {-19161, 62672},
+    {-20252, 62328}, {-21336, 61966}, {-22415, 61584}, {-23486, 61183},
+    {-24550, 60764}, {-25607, 60326}, {-26656, 59870}, {-27697, 59396},
+    {-28729, 58903}, {-29753, 58393}, {-30767, 57865}, {-31772, 57319},
+};
+
+// Converte um retângulo em pixels pra unidades de sub-pixel
+static SDL_Rect toSubpixelRect(SDL_Rect rect)
+{
+    SDL_Rect subpixel = {rect.x << MISSILE_SUBPIXEL_BITS, rect.y << MISSILE_SUBPIXEL_BITS, rect.w << MISSILE_SUBPIXEL_BITS, rect.h << MISSILE_SUBPIXEL_BITS};
+    return subpixel;
+}
+
+// Restringe [enter, exit] ao intervalo do tick em que o segmento [position, position + size),
+// andando delta, sobrepõe [rectPosition, rectPosition + rectSize) em um eixo.
+// Parado, basta o teste estático
+static bool sweepAxis(int position, int size, int delta, int rectPosition, int rectSize, double *enter, double *exit)
+{
+    if (delta == 0)
+        return position < rectPosition + rectSize && position + size > rectPosition;
+
+    double a = (double)(rectPosition - position - size) / delta;
+    double b = (double)(rectPosition + rectSize - position) / delta;
+    if (a > b)
+    {
+        double swap = a;
+        a = b;
+        b = swap;
+    }
+
+    if (a > *enter)
+        *enter = a;
+    if (b < *exit)
+        *exit = b;
+    return true;
+}
+
+// Teste contínuo (swept AABB) em sub-pixels: o míssil sai de (x, y) e anda (dx, dy) durante
+// o tick, com rect parado. Detecta o toque em qualquer instante do tick, mesmo quando
+// o míssil atravessa rect inteiro entre duas posições
+static bool missileSweepOverlaps(int x, int y, int dx, int dy, SDL_Rect rect)
+{
+    // -1 e 2 ficam fora do tick, então não limitam nada se algum eixo estiver parado
+    double enter = -1.0, exit = 2.0;
+
+    if (!sweepAxis(x, MISSILE_SUBPIXEL_WIDTH, dx, rect.x, rect.w, &enter, &exit) ||
+        !sweepAxis(y, MISSILE_SUBPIXEL_HEIGHT, dy, rect.y, rect.h, &enter, &exit))
+        return false;
+
+    return enter < exit && enter < 1.0 && exit > 0.0;
+}
+
+// Inicializa o sistema com arrays fixos de mísseis, alocados uma única vez.
+// Depois disso nada mais é alocado, quantos mísseis forem criados e destruídos: a grade
+// já reserva o pior caso, todos os mísseis com a caixa do passo de maxSpeed pixels
+// (a maior velocidade passada pra spawnMissile) na posição que cobre mais células.
+// A capacidade dos arrays densos é arredondada pra um múltiplo de 8, a largura dos kernels AVX2
+void initMissileSystem(MissileSystem *system, int numSlots, int maxSpeed)
+{
+    int capacity = (2 * numSlots + 7) & ~7;
+
+    system->x = (int *)malloc(sizeof(int) * capacity);
+    system->y = (int *)malloc(sizeof(int) * capacity);
+    system->vx = (int *)malloc(sizeof(int) * capacity);
+    system->vy = (int *)malloc(sizeof(int) * capacity);
+    system->active = (Uint8 *)calloc(capacity, sizeof(Uint8));
+    system->numMissiles = 0;
+    system->capacity = capacity;
+    system->needsCompaction = false;
+
+    system->denseToSlot = (int *)malloc(sizeof(int) * capacity);
+    system->slotToDense = (int *)malloc(sizeof(int) * numSlots);
+    system->generations = (Uint32 *)calloc(numSlots, sizeof(Uint32));
+    system->freeSlots = (int *)malloc(sizeof(int) * numSlots);
+    system->slotMarks = (Uint8 *)malloc(numSlots);
+    system->numSlots = numSlots;
+    // a lista livre é uma pilha; os primeiros slots ficam no topo
+    for (int i = 0; i < numSlots; i++)
+        system->freeSlots[i] = numSlots - 1 - i;
+    system->numFreeSlots = numSlots;
+    system->usedSlots = 0;
+    pthread_mutex_init(&system->lock, NULL);
+    system->kernels = selectMissileKernels();
+
+    initSpatialGrid(&system->grid, SCREEN_WIDTH, SCREEN_HEIGHT, 64);
+    // o passo arredondado pra pixels anda até um pixel a mais que maxSpeed
+    int cellsPerBox = getSpatialGridMaxCells(&system->grid, maxSpeed + 1 + MISSILE_WIDTH, maxSpeed + 1 + MISSILE_HEIGHT);
+    reserveSpatialGrid(&system->grid, capacity * cellsPerBox);
+    system->boxes = (SDL_Rect *)malloc(sizeof(SDL_Rect) * capacity);
+    system->candidates = (int *)malloc(sizeof(int) * capacity);
+
+    system->ticks = 0;
+    system->totalTickTime = 0;
+    system->maxTickTime = 0;
+    system->peakMissiles = 0;
+    system->spawned = 0;
+    system->recycled = 0;
+    system->poolExhausted = 0;
+}
+
+void destroyMissileSystem(MissileSystem *system)
+{
+    free(system->x);
+    free(system->y);
+    free(system->vx);
+    free(system->vy);
+    free(system->active);
+    free(system->boxes);
+    free(system->candidates);
+    free(system->denseToSlot);
+    free(system->slotToDense);
+    free(system->generations);
+    free(system->freeSlots);
+    free(system->slotMarks);
+    destroySpatialGrid(&system->grid);
+    system->x = system->y = system->vx = system->vy = NULL;
+    system->active = NULL;
+    system->numMissiles = 0;
+    pthread_mutex_destroy(&system->lock);
+}
+
+// Adiciona um míssil ao sistema, com ângulo em graus inteiros (0 a MISSILE_NUM_ANGLES - 1).
+// Retorna false se não houver slot livre
+bool spawnMissile(MissileSystem *system, int x, int y, int speed, int angle)
+{
+    Uint64 lockStart = traceBegin();
+    pthread_mutex_lock(&system->lock);
+    traceEnd("lock dos mísseis", "locks", lockStart);
+
+    if (system->numFreeSlots == 0 || system->numMissiles == system->capacity)
+    {
+        system->poolExhausted++;
+        pthread_mutex_unlock(&system->lock);
+        return false;
+    }
+
+    // posição e velocidade ficam em sub-pixels; a velocidade vem da tabela e é arredondada
+    // uma única vez, sem perder o movimento fracionário dos ângulos rasos
+    int i = system->numMissiles;
+    int half = 1 << (15 - MISSILE_SUBPIXEL_BITS);
+    system->x[i] = x << MISSILE_SUBPIXEL_BITS;
+    system->y[i] = y << MISSILE_SUBPIXEL_BITS;
+    system->vx[i] = (speed * missileDirections[angle][0] + half) >> (16 - MISSILE_SUBPIXEL_BITS);
+    system->vy[i] = -((speed * missileDirections[angle][1] + half) >> (16 - MISSILE_SUBPIXEL_BITS));
+    system->active[i] = 1;
+
+    int slot = system->freeSlots[--system->numFreeSlots];
+    system->denseToSlot[i] = slot;
+    system->slotToDense[slot] = i;
+    if (slot >= system->usedSlots)
+        system->usedSlots = slot + 1;
+
+    system->numMissiles++;
+    system->spawned++;
+    if (system->generations[slot] > 0)
+        system->recycled++;
+    int alive = system->numSlots - system->numFreeSlots;
+    if (alive > system->peakMissiles)
+        system->peakMissiles = alive;
+
+    pthread_mutex_unlock(&system->lock);
+    return true;
+}
+
+// Devolve à lista livre os slots dos mísseis desativados no tick, mudando a geração
+// pro próximo míssil do slot. A posição densa só é removida na compactação
+static void releaseDeactivatedSlots(MissileSystem *system)
+{
+    for (int i = 0; i < system->numMissiles; i++)
+    {
+        int slot = system->denseToSlot[i];
+        if (system->active[i] || slot < 0)
+            continue;
+
+        system->generations[slot]++;
+        system->freeSlots[system->numFreeSlots++] = slot;
+        system->denseToSlot[i] = -1;
+    }
+}
+
+// Remove os mísseis desativados trocando-os pelo último ativo, mantendo os arrays densos
+static void compactMissiles(MissileSystem *system)
+{
+    int i = 0;
+    while (i < system->numMissiles)
+    {
+        if (system->active[i])
+        {
+            i++;
+            continue;
+        }
+
+        int last = system->numMissiles - 1;
+        system->x[i] = system->x[last];
+        system->y[i] = system->y[last];
+        system->vx[i] = system->vx[last];
+        system->vy[i] = system->vy[last];
+        system->active[i] = system->active[last];
+        system->denseToSlot[i] = system->denseToSlot[last];
+        if (system->denseToSlot[i] >= 0)
+            system->slotToDense[system->denseToSlot[i]] = i;
+        system->active[last] = 0;
+        system->numMissiles--;
+    }
+}
+
+// Reconstrói a grade com as caixas em pixels de todo o caminho que cada míssil ativo
+// percorreu no último passo, da posição anterior até a atual
+static void buildMissileGrid(MissileSystem *system)
+{
+    for (int i = 0; i < system->numMissiles; i++)
+    {
+        if (!system->active[i])
+        {
+            system->boxes[i] = (SDL_Rect){system->x[i] >> MISSILE_SUBPIXEL_BITS, system->y[i] >> MISSILE_SUBPIXEL_BITS, 0, 0};
+            continue;
+        }
+
+        int previousX = (system->x[i] - system->vx[i]) >> MISSILE_SUBPIXEL_BITS;
+        int previousY = (system->y[i] - system->vy[i]) >> MISSILE_SUBPIXEL_BITS;
+        int currentX = system->x[i] >> MISSILE_SUBPIXEL_BITS;
+        int currentY = system->y[i] >> MISSILE_SUBPIXEL_BITS;
+
+        system->boxes[i].x = SDL_min(previousX, currentX);
+        system->boxes[i].y = SDL_min(previousY, currentY);
+        system->boxes[i].w = abs(currentX - previousX) + MISSILE_WIDTH;
+        system->boxes[i].h = abs(currentY - previousY) + MISSILE_HEIGHT;
+    }
+
+    buildSpatialGrid(&system->grid, system->boxes, system->numMissiles);
+}
+
+// Desativa os mísseis que tocaram o obstáculo em algum instante do último passo,
+// testando só os das células que ele cobre
+static int cullMissilesAgainst(MissileSystem *system, SDL_Rect obstacle)
+{
+    int culled = 0;
+    int numCandidates = querySpatialGrid(&system->grid, obstacle, system->candidates, system->capacity);
+    SDL_Rect subpixelObstacle = toSubpixelRect(obstacle);
+
+    for (int k = 0; k < numCandidates; k++)
+    {
+        int i = system->candidates[k];
+        if (system->active[i] &&
+            missileSweepOverlaps(system->x[i] - system->vx[i], system->y[i] - system->vy[i], system->vx[i], system->vy[i], subpixelObstacle))
+        {
+            system->active[i] = 0;
+            system->vx[i] = 0;
+            system->vy[i] = 0;
+            culled++;
+        }
+    }
+
+    return culled;
+}
+
+// Primeira metade do tick dos mísseis: avança todos os ativos em um passo de tempo fixo
+// e monta a grade com o caminho de cada um nesse passo. Entre ela e cullMissileSystem,
+// os helicópteros são testados contra esse caminho com checkMissileSystemCollision,
+// no mesmo intervalo em que eles próprios se moveram
+void moveMissileSystem(MissileSystem *system)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    pthread_mutex_lock(&system->lock);
+
+    // remove os mísseis desativados no tick anterior. Isso só acontece aqui porque
+    // a grade guarda índices e precisa continuar válida até o fim do tick
+    if (system->needsCompaction)
+        compactMissiles(system);
+
+    // Atualiza as posições lógicas de todos os mísseis
+    system->kernels.move(system->x, system->y, system->vx, system->vy, system->numMissiles);
+    buildMissileGrid(system);
+
+    pthread_mutex_unlock(&system->lock);
+
+    system->moveTime = SDL_GetPerformanceCounter() - start;
+}
+
+// Segunda metade do tick dos mísseis: desativa os que saíram da tela e os que tocaram
+// algum dos obstáculos (os prédios) em algum instante do passo
+void cullMissileSystem(MissileSystem *system, const SDL_Rect *obstacles, int numObstacles)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    // a tela é convertida pra sub-pixels, com as mesmas bordas do teste em pixels
+    SDL_Rect screen = toSubpixelRect((SDL_Rect){0, 0, SCREEN_WIDTH, SCREEN_HEIGHT});
+    screen.w += MISSILE_SUBPIXEL_ONE - 1;
+    screen.h += MISSILE_SUBPIXEL_ONE - 1;
+
+    pthread_mutex_lock(&system->lock);
+
+    // Desativa os mísseis que saíram da tela
+    int culled = system->kernels.cull(
+        system->x, system->y, system->vx, system->vy, system->active, system->numMissiles, screen);
+
+    // Desativa os que atingiram um prédio, consultando a grade
+    for (int o = 0; o < numObstacles; o++)
+        culled += cullMissilesAgainst(system, obstacles[o]);
+
+    system->needsCompaction = culled > 0;
+    if (culled > 0)
+        releaseDeactivatedSlots(system);
+
+    pthread_mutex_unlock(&system->lock);
+
+    // o custo do tick soma as duas metades
+    Uint64 elapsed = system->moveTime + SDL_GetPerformanceCounter() - start;
+    system->ticks++;
+    system->totalTickTime += elapsed;
+    if (elapsed > system->maxTickTime)
+        system->maxTickTime = elapsed;
+}
+
+// Verifica se algum míssil ativo tocou o retângulo enquanto ele ia de from até to.
+// Os dois se movem durante o passo, então o teste é feito no referencial do retângulo:
+// o míssil sai da posição anterior e anda a sua velocidade menos o deslocamento do retângulo
+bool checkMissileSystemCollision(MissileSystem *system, SDL_Rect *from, SDL_Rect *to)
+{
+    SDL_Rect path;
+    SDL_UnionRect(from, to, &path);
+    SDL_Rect start = toSubpixelRect(*from);
+    int dx = (to->x - from->x) << MISSILE_SUBPIXEL_BITS;
+    int dy = (to->y - from->y) << MISSILE_SUBPIXEL_BITS;
+
+    pthread_mutex_lock(&system->lock);
+
+    bool hit = false;
+    int numCandidates = querySpatialGrid(&system->grid, path, system->candidates, system->capacity);
+    for (int k = 0; k < numCandidates && !hit; k++)
+    {
+        int i = system->candidates[k];
+        hit = system->active[i] &&
+              missileSweepOverlaps(system->x[i] - system->vx[i], system->y[i] - system->vy[i],
+                                   system->vx[i] - dx, system->vy[i] - dy, start);
+    }
+
+    pthread_mutex_unlock(&system->lock);
+
+    return hit;
+}
+
+// Cabeçalho do estado salvo do sistema. Depois dele vêm slotToDense e generations dos slots
+// já usados, o topo da lista livre acima dos slots nunca usados e os arrays densos (numMissiles).
+// Os slots nunca usados não precisam ser salvos: estão no fundo da lista livre, na ordem inicial
+typedef struct
+{
+    Sint32 numSlots;
+    Sint32 usedSlots;
+    Sint32 numMissiles;
+    Sint32 numFreeSlots;
+    Sint32 needsCompaction;
+} SavedMissileSystem;
+
+size_t getMaxMissileSystemStateSize(MissileSystem *system)
+{
+    return sizeof(SavedMissileSystem) + (sizeof(int) * 3) * system->numSlots +
+           (sizeof(int) * 5 + sizeof(Uint8)) * system->capacity;
+}
+
+static Uint8 *saveArray(Uint8 *out, const void *data, size_t size)
+{
+    memcpy(out, data, size);
+    return out + size;
+}
+
+static const Uint8 *restoreArray(const Uint8 *in, void *data, size_t size)
+{
+    memcpy(data, in, size);
+    return in + size;
+}
+
+// Copia o estado do sistema pra out, incluindo os mísseis desativados que ainda não foram
+// compactados e a ordem da lista livre, pra que a sessão restaurada continue igual.
+// Retorna o número de bytes escritos
+size_t saveMissileSystemState(MissileSystem *system, Uint8 *out)
+{
+    Uint8 *start = out;
+    int n = system->numMissiles;
+    int unused = system->numSlots - system->usedSlots;
+    SavedMissileSystem saved = {system->numSlots, system->usedSlots, n, system->numFreeSlots, system->needsCompaction};
+
+    out = saveArray(out, &saved, sizeof(saved));
+    out = saveArray(out, system->slotToDense, sizeof(int) * system->usedSlots);
+    out = saveArray(out, system->generations, sizeof(Uint32) * system->usedSlots);
+    out = saveArray(out, system->freeSlots + unused, sizeof(int) * (system->numFreeSlots - unused));
+    out = saveArray(out, system->x, sizeof(int) * n);
+    out = saveArray(out, system->y, sizeof(int) * n);
+    out = saveArray(out, system->vx, sizeof(int) * n);
+    out = saveArray(out, system->vy, sizeof(int) * n);
+    out = saveArray(out, system->denseToSlot, sizeof(int) * n);
+    out = saveArray(out, system->active, n);
+    return out - start;
+}
+
+static int readSavedInt(const Uint8 *in, int i)
+{
+    int value;
+    memcpy(&value, in + sizeof(int) * i, sizeof(int));
+    return value;
+}
+
+// Confere os índices do estado salvo antes de copiar qualquer coisa: cada slot usado tem
+// que estar exatamente uma vez na lista livre ou em um míssil dos arrays densos, com
+// slotToDense apontando de volta pra ele, e nenhum índice pode sair dos arrays
+static bool validateSavedMissiles(MissileSystem *system, const SavedMissileSystem *saved, const Uint8 *in)
+{
+    int unused = saved->numSlots - saved->usedSlots;
+    int n = saved->numMissiles;
+    const Uint8 *slotToDense = in;
+    const Uint8 *freeSlots = slotToDense + (sizeof(int) * 2) * saved->usedSlots;
+    const Uint8 *denseToSlot = freeSlots + sizeof(int) * (saved->numFreeSlots - unused) + (sizeof(int) * 4) * n;
+    const Uint8 *active = denseToSlot + sizeof(int) * n;
+
+    memset(system->slotMarks, 0, saved->usedSlots);
+    int marked = 0;
+    for (int i = 0; i < saved->usedSlots; i++)
+    {
+        int dense = readSavedInt(slotToDense, i);
+        if (dense < 0 || dense >= system->capacity)
+            return false;
+    }
+    for (int i = 0; i < saved->numFreeSlots - unused; i++)
+    {
+        int slot = readSavedInt(freeSlots, i);
+        if (slot < 0 || slot >= saved->usedSlots || system->slotMarks[slot])
+            return false;
+        system->slotMarks[slot] = 1;
+        marked++;
+    }
+    for (int i = 0; i < n; i++)
+    {
+        int slot = readSavedInt(denseToSlot, i);
+        if (slot < 0)
+        {
+            if (active[i])
+                return false;
+            continue;
+        }
+        if (slot >= saved->usedSlots || system->slotMarks[slot] || readSavedInt(slotToDense, slot) != i)
+            return false;
+        system->slotMarks[slot] = 1;
+        marked++;
+    }
+
+    return marked == saved->usedSlots;
+}
+
+// Restaura o estado salvo por saveMissileSystemState. A grade não precisa ser reconstruída:
+// o próximo tick a monta de novo antes de qualquer consulta. size pode incluir preenchimento depois do estado.
+// Retorna false, sem mudar nada, se o estado não for deste sistema
+bool restoreMissileSystemState(MissileSystem *system, const Uint8 *in, size_t size)
+{
+    SavedMissileSystem saved;
+    if (size < sizeof(saved))
+        return false;
+    memcpy(&saved, in, sizeof(saved));
+
+    int unused = saved.numSlots - saved.usedSlots;
+    size_t expected = sizeof(saved) + (sizeof(int) * 2) * saved.usedSlots + sizeof(int) * (saved.numFreeSlots - unused) +
+                      (sizeof(int) * 5 + sizeof(Uint8)) * saved.numMissiles;
+    if (saved.numSlots != system->numSlots || saved.usedSlots < 0 || saved.usedSlots > saved.numSlots ||
+        saved.numMissiles < 0 || saved.numMissiles > system->capacity ||
+        saved.numFreeSlots < unused || saved.numFreeSlots > system->numSlots || size < expected ||
+        !validateSavedMissiles(system, &saved, in + sizeof(saved)))
+        return false;
+
+    pthread_mutex_lock(&system->lock);
+
+    int n = saved.numMissiles;
+    in += sizeof(saved);
+    // os slots usados depois do estado salvo voltam a ser nunca usados
+    for (int slot = saved.usedSlots; slot < system->usedSlots; slot++)
+    {
+        system->generations[slot] = 0;
+        system->freeSlots[system->numSlots - 1 - slot] = slot;
+    }
+    in = restoreArray(in, system->slotToDense, sizeof(int) * saved.usedSlots);
+    in = restoreArray(in, system->generations, sizeof(Uint32) * saved.usedSlots);
+    in = restoreArray(in, system->freeSlots + unused, sizeof(int) * (saved.numFreeSlots - unused));
+    in = restoreArray(in, system->x, sizeof(int) * n);
+    in = restoreArray(in, system->y, sizeof(int) * n);
+    in = restoreArray(in, system->vx, sizeof(int) * n);
+    in = restoreArray(in, system->vy, sizeof(int) * n);
+    in = restoreArray(in, system->denseToSlot, sizeof(int) * n);
+    in = restoreArray(in, system->active, n);
+    memset(system->active + n, 0, system->capacity - n);
+
+    system->numMissiles = n;
+    system->numFreeSlots = saved.numFreeSlots;
+    system->usedSlots = saved.usedSlots;
+    system->needsCompaction = saved.needsCompaction;
+
+    pthread_mutex_unlock(&system->lock);
+    return true;
+}
+
+void printMissileSystemStats(MissileSystem *system)
+{
+    if (system->ticks == 0)
+        return;
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    printf("\nSistema de mísseis (kernels %s): %llu ticks, custo médio %.2f us/tick, pior tick %.2f us, pico de %d mísseis\n",
+           system->kernels.name,
+           (unsigned long long)system->ticks,
+           system->totalTickTime * 1e6 / frequency / system->ticks,
+           system->maxTickTime * 1e6 / frequency,
+           system->peakMissiles);
+    printf("Pool de mísseis: %d slots, %llu criados, %llu em slots reaproveitados, %llu recusados por falta de slot\n",
+           system->numSlots,
+           (unsigned long long)system->spawned,
+           (unsigned long long)system->recycled,
+           (unsigned long long)system->poolExhausted);
+}
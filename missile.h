@@ -0,0 +1,85 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "missile_simd.h"
+#include "broadphase.h"
+
+#ifndef MISSILE_H
+#define MISSILE_H
+
+// Ângulos de disparo possíveis, em graus inteiros
+#define MISSILE_NUM_ANGLES 120
+
+// As posições dos mísseis ficam em ponto fixo: 1 pixel = MISSILE_SUBPIXEL_ONE sub-pixels
+#define MISSILE_SUBPIXEL_BITS 8
+#define MISSILE_SUBPIXEL_ONE (1 << MISSILE_SUBPIXEL_BITS)
+
+// Largura e altura usadas nos testes em sub-pixels. Como a posição em pixels é o
+// arredondamento pra baixo, um míssil de w pixels alcança até w * ONE - (ONE - 1) sub-pixels
+// além da sua posição sem deixar de cobrir o mesmo pixel
+#define MISSILE_SUBPIXEL_WIDTH ((MISSILE_WIDTH << MISSILE_SUBPIXEL_BITS) - (MISSILE_SUBPIXEL_ONE - 1))
+#define MISSILE_SUBPIXEL_HEIGHT ((MISSILE_HEIGHT << MISSILE_SUBPIXEL_BITS) - (MISSILE_SUBPIXEL_ONE - 1))
+
+// Sistema que avança todos os mísseis ativos em um único passo de tempo fixo,
+// em vez de uma thread por míssil.
+// Os campos usados a cada tick ficam em arrays contíguos separados (struct of arrays),
+// pra que os kernels SIMD processem vários mísseis por instrução.
+// As colisões com prédios e helicópteros são contínuas, então um míssil rápido
+// (ou um tick longo) não atravessa nada entre duas posições
+typedef struct
+{
+    // posições e velocidades (por tick) em sub-pixels
+    int *x;
+    int *y;
+    int *vx;
+    int *vy;
+    Uint8 *active;
+    int numMissiles;
+    int capacity;
+
+    // Pool de slots com lista livre: cada míssil vivo ocupa um slot, que aponta pra sua
+    // posição nos arrays densos. Os arrays densos têm o dobro de posições que o pool tem slots,
+    // pra caber os mísseis criados antes da compactação dos que foram desativados no tick
+    int *denseToSlot; // -1 se o míssil já foi desativado e o slot liberado
+    int *slotToDense;
+    Uint32 *generations; // muda a cada reuso do slot, pros espectadores saberem que é outro míssil
+    int *freeSlots;
+    Uint8 *slotMarks; // rascunho da validação de um estado salvo
+    int numFreeSlots;
+    int numSlots;
+    // slots já usados alguma vez; os outros continuam no fundo da lista livre, na ordem inicial
+    int usedSlots;
+    bool needsCompaction;
+    pthread_mutex_t lock;
+    MissileKernels kernels;
+
+    // Grade com as caixas (em pixels) do caminho de cada míssil ativo no último passo,
+    // reconstruída a cada tick. Os candidatos de uma consulta passam pelo teste contínuo
+    SpatialGrid grid;
+    SDL_Rect *boxes;
+    int *candidates;
+
+    // Estatísticas do custo de cada tick (em contagens do SDL_GetPerformanceCounter)
+    Uint64 ticks;
+    Uint64 totalTickTime;
+    Uint64 maxTickTime;
+    Uint64 moveTime; // custo de moveMissileSystem no tick atual
+    int peakMissiles;
+    Uint64 spawned;
+    Uint64 recycled;
+    Uint64 poolExhausted;
+} MissileSystem;
+
+void initMissileSystem(MissileSystem *system, int numSlots, int maxSpeed);
+void destroyMissileSystem(MissileSystem *system);
+bool spawnMissile(MissileSystem *system, int x, int y, int speed, int angle);
+void moveMissileSystem(MissileSystem *system);
+void cullMissileSystem(MissileSystem *system, const SDL_Rect *obstacles, int numObstacles);
+bool checkMissileSystemCollision(MissileSystem *system, SDL_Rect *from, SDL_Rect *to);
+size_t getMaxMissileSystemStateSize(MissileSystem *system);
+size_t saveMissileSystemState(MissileSystem *system, Uint8 *out);
+bool restoreMissileSystemState(MissileSystem *system, const Uint8 *in, size_t size);
+void printMissileSystemStats(MissileSystem *system);
+
+#endif /* MISSILE_H */
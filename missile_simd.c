@@ -0,0 +1,182 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "missile_simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MISSILE_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Versão escalar, usada como referência e fora de x86
+
+static inline bool missileOutside(int x, int y, SDL_Rect bounds)
+{
+    return x < bounds.x || x > bounds.x + bounds.w || y < bounds.y || y > bounds.y + bounds.h;
+}
+
+static void moveScalar(int *x, int *y, const int *vx, const int *vy, int n)
+{
+    for (int i = 0; i < n; i++)
+    {
+        x[i] += vx[i];
+        y[i] += vy[i];
+    }
+}
+
+static int cullOne(const int *x, const int *y, int *vx, int *vy, Uint8 *active, int i, SDL_Rect bounds)
+{
+    if (!active[i] || !missileOutside(x[i], y[i], bounds))
+        return 0;
+
+    active[i] = 0;
+    vx[i] = 0;
+    vy[i] = 0;
+    return 1;
+}
+
+static int cullScalar(const int *x, const int *y, int *vx, int *vy, Uint8 *active, int n, SDL_Rect bounds)
+{
+    int culled = 0;
+    for (int i = 0; i < n; i++)
+        culled += cullOne(x, y, vx, vy, active, i, bounds);
+    return culled;
+}
+
+#ifdef MISSILE_SIMD_X86
+
+// Desativa os mísseis marcados nos bits de "mask", a partir do índice base
+static inline int killLanes(int mask, int base, int *vx, int *vy, Uint8 *active)
+{
+    int culled = 0;
+    while (mask != 0)
+    {
+        int lane = __builtin_ctz(mask);
+        mask &= mask - 1;
+        if (active[base + lane])
+        {
+            active[base + lane] = 0;
+            vx[base + lane] = 0;
+            vy[base + lane] = 0;
+            culled++;
+        }
+    }
+    return culled;
+}
+
+// ---------------------------------------------------------------------------
+// SSE2 (4 mísseis por instrução)
+
+static void moveSSE2(int *x, int *y, const int *vx, const int *vy, int n)
+{
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i px = _mm_loadu_si128((const __m128i *)(x + i));
+        __m128i py = _mm_loadu_si128((const __m128i *)(y + i));
+        px = _mm_add_epi32(px, _mm_loadu_si128((const __m128i *)(vx + i)));
+        py = _mm_add_epi32(py, _mm_loadu_si128((const __m128i *)(vy + i)));
+        _mm_storeu_si128((__m128i *)(x + i), px);
+        _mm_storeu_si128((__m128i *)(y + i), py);
+    }
+    moveScalar(x + i, y + i, vx + i, vy + i, n - i);
+}
+
+static int cullSSE2(const int *x, const int *y, int *vx, int *vy, Uint8 *active, int n, SDL_Rect bounds)
+{
+    int culled = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i px = _mm_loadu_si128((const __m128i *)(x + i));
+        __m128i py = _mm_loadu_si128((const __m128i *)(y + i));
+
+        __m128i dead = _mm_cmpgt_epi32(_mm_set1_epi32(bounds.x), px);
+        dead = _mm_or_si128(dead, _mm_cmpgt_epi32(px, _mm_set1_epi32(bounds.x + bounds.w)));
+        dead = _mm_or_si128(dead, _mm_cmpgt_epi32(_mm_set1_epi32(bounds.y), py));
+        dead = _mm_or_si128(dead, _mm_cmpgt_epi32(py, _mm_set1_epi32(bounds.y + bounds.h)));
+
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(dead));
+        if (mask != 0)
+            culled += killLanes(mask, i, vx, vy, active);
+    }
+
+    return culled + cullScalar(x + i, y + i, vx + i, vy + i, active + i, n - i, bounds);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 (8 mísseis por instrução), compilado só para estas funções
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET static void moveAVX2(int *x, int *y, const int *vx, const int *vy, int n)
+{
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i px = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i py = _mm256_loadu_si256((const __m256i *)(y + i));
+        px = _mm256_add_epi32(px, _mm256_loadu_si256((const __m256i *)(vx + i)));
+        py = _mm256_add_epi32(py, _mm256_loadu_si256((const __m256i *)(vy + i)));
+        _mm256_storeu_si256((__m256i *)(x + i), px);
+        _mm256_storeu_si256((__m256i *)(y + i), py);
+    }
+    moveScalar(x + i, y + i, vx + i, vy + i, n - i);
+}
+
+AVX2_TARGET static int cullAVX2(const int *x, const int *y, int *vx, int *vy, Uint8 *active, int n, SDL_Rect bounds)
+{
+    int culled = 0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256i px = _mm256_loadu_si256((const __m256i *)(x + i));
+        __m256i py = _mm256_loadu_si256((const __m256i *)(y + i));
+
+        __m256i dead = _mm256_cmpgt_epi32(_mm256_set1_epi32(bounds.x), px);
+        dead = _mm256_or_si256(dead, _mm256_cmpgt_epi32(px, _mm256_set1_epi32(bounds.x + bounds.w)));
+        dead = _mm256_or_si256(dead, _mm256_cmpgt_epi32(_mm256_set1_epi32(bounds.y), py));
+        dead = _mm256_or_si256(dead, _mm256_cmpgt_epi32(py, _mm256_set1_epi32(bounds.y + bounds.h)));
+
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(dead));
+        if (mask != 0)
+            culled += killLanes(mask, i, vx, vy, active);
+    }
+
+    return culled + cullScalar(x + i, y + i, vx + i, vy + i, active + i, n - i, bounds);
+}
+
+#endif /* MISSILE_SIMD_X86 */
+
+// Escolhe a melhor versão suportada pela CPU. MISSILE_KERNELS=scalar|sse2 força uma versão
+MissileKernels selectMissileKernels()
+{
+    MissileKernels kernels = {"escalar", moveScalar, cullScalar};
+    const char *forced = getenv("MISSILE_KERNELS");
+
+    if (forced != NULL && strcmp(forced, "scalar") == 0)
+        return kernels;
+
+#ifdef MISSILE_SIMD_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("sse2"))
+    {
+        kernels.name = "SSE2";
+        kernels.move = moveSSE2;
+        kernels.cull = cullSSE2;
+    }
+
+    if ((forced == NULL || strcmp(forced, "sse2") != 0) && __builtin_cpu_supports("avx2"))
+    {
+        kernels.name = "AVX2";
+        kernels.move = moveAVX2;
+        kernels.cull = cullAVX2;
+    }
+#endif
+
+    return kernels;
+}
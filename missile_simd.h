@@ -0,0 +1,23 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef MISSILE_SIMD_H
+#define MISSILE_SIMD_H
+
+// Kernels que processam os arrays de mísseis em lote.
+// Há versões AVX2, SSE2 e escalar, escolhidas em tempo de execução
+typedef struct
+{
+    const char *name;
+    // x += vx, y += vy para todos os mísseis
+    void (*move)(int *x, int *y, const int *vx, const int *vy, int n);
+    // desativa (e zera a velocidade de) mísseis fora de bounds. Os prédios e helicópteros
+    // ficam com o teste contínuo sobre os candidatos da grade, que são poucos por tick.
+    // Retorna quantos mísseis foram desativados
+    int (*cull)(const int *x, const int *y, int *vx, int *vy, Uint8 *active, int n, SDL_Rect bounds);
+} MissileKernels;
+
+MissileKernels selectMissileKernels();
+
+#endif /* MISSILE_SIMD_H */
@@ -0,0 +1,76 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "pacing.h"
+#include "trace.h"
+
+// Abaixo disso a thread fica girando em vez de dormir, porque o SDL_Delay
+// costuma acordar alguns milissegundos depois do pedido
+#define FRAME_SPIN_TIME_US 1500
+
+void initFramePacer(FramePacer *pacer, int targetFps, bool vsync)
+{
+    pacer->targetFps = targetFps;
+    pacer->vsync = vsync;
+    pacer->frequency = SDL_GetPerformanceFrequency();
+    pacer->frameDuration = targetFps > 0 ? pacer->frequency / targetFps : 0;
+    pacer->startTime = SDL_GetPerformanceCounter();
+    pacer->nextFrame = pacer->startTime + pacer->frameDuration;
+    pacer->frames = 0;
+    pacer->sleepTime = 0;
+    pacer->droppedDeadlines = 0;
+}
+
+// Espera até o horário do próximo quadro. Os horários seguem uma grade fixa pra que
+// o erro de cada espera não se acumule; se um quadro atrasou mais que um período
+// inteiro, a grade recomeça a partir de agora em vez de desenhar vários quadros seguidos
+void waitForNextFrame(FramePacer *pacer)
+{
+    pacer->frames++;
+
+    if (pacer->frameDuration == 0)
+        return;
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now >= pacer->nextFrame)
+    {
+        if (now - pacer->nextFrame > pacer->frameDuration)
+        {
+            pacer->droppedDeadlines++;
+            pacer->nextFrame = now;
+        }
+        pacer->nextFrame += pacer->frameDuration;
+        return;
+    }
+
+    Uint64 traceStart = traceBegin();
+    Uint64 spinTime = pacer->frequency * FRAME_SPIN_TIME_US / 1000000;
+    Uint64 remaining = pacer->nextFrame - now;
+    if (remaining > spinTime)
+        SDL_Delay((Uint32)((remaining - spinTime) * 1000 / pacer->frequency));
+
+    while (SDL_GetPerformanceCounter() < pacer->nextFrame)
+        ;
+
+    traceEnd("espera do quadro", "quadro", traceStart);
+    pacer->sleepTime += SDL_GetPerformanceCounter() - now;
+    pacer->nextFrame += pacer->frameDuration;
+}
+
+void printFramePacerStats(FramePacer *pacer)
+{
+    double elapsed = (double)(SDL_GetPerformanceCounter() - pacer->startTime) / pacer->frequency;
+    if (pacer->frames == 0 || elapsed <= 0)
+        return;
+
+    printf("\nQuadros: %llu em %.1f s (%.1f fps, ", (unsigned long long)pacer->frames, elapsed, pacer->frames / elapsed);
+    if (pacer->vsync)
+        printf("vsync");
+    else if (pacer->targetFps > 0)
+        printf("alvo de %d fps", pacer->targetFps);
+    else
+        printf("sem limite");
+    printf("), %.1f%% do tempo esperando, %llu prazos perdidos\n",
+           100.0 * pacer->sleepTime / pacer->frequency / elapsed,
+           (unsigned long long)pacer->droppedDeadlines);
+}
@@ -0,0 +1,29 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef PACING_H
+#define PACING_H
+
+// Controla o ritmo dos quadros do renderizador. Com vsync, quem limita é o SDL_RenderPresent;
+// sem vsync, a thread dorme até o próximo quadro. targetFps 0 desenha sem limite
+typedef struct
+{
+    int targetFps;
+    bool vsync;
+    Uint64 frequency;
+    Uint64 frameDuration;
+    Uint64 nextFrame;
+
+    // Estatísticas
+    Uint64 startTime;
+    Uint64 frames;
+    Uint64 sleepTime;
+    Uint64 droppedDeadlines;
+} FramePacer;
+
+void initFramePacer(FramePacer *pacer, int targetFps, bool vsync);
+void waitForNextFrame(FramePacer *pacer);
+void printFramePacerStats(FramePacer *pacer);
+
+#endif /* PACING_H */
@@ -0,0 +1,168 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "recording.h"
+
+// Cabeçalho do arquivo, seguido de numRuns trechos: uma contagem de ticks (Uint32)
+// e a linha de comandos repetida nesses ticks
+typedef struct
+{
+    Uint32 magic;
+    Uint32 version;
+    SessionConfig config;
+    Sint32 numTicks;
+    Sint32 numRuns;
+    Uint64 finalChecksum;
+} InputRecordingHeader;
+
+void initInputRecording(InputRecording *recording, const SessionConfig *config)
+{
+    recording->config = *config;
+    recording->numTicks = 0;
+    recording->capacity = 1024;
+    recording->inputs = (Uint8 *)malloc((size_t)recording->capacity * config->numHelicopters);
+    recording->finalChecksum = 0;
+}
+
+void freeInputRecording(InputRecording *recording)
+{
+    free(recording->inputs);
+    recording->inputs = NULL;
+    recording->numTicks = 0;
+    recording->capacity = 0;
+}
+
+// Acrescenta os comandos de um tick
+void recordInputs(InputRecording *recording, const Uint8 *inputs)
+{
+    int rowSize = recording->config.numHelicopters;
+
+    if (recording->numTicks == recording->capacity)
+    {
+        recording->capacity *= 2;
+        recording->inputs = (Uint8 *)realloc(recording->inputs, (size_t)recording->capacity * rowSize);
+    }
+
+    memcpy(&recording->inputs[(size_t)recording->numTicks * rowSize], inputs, rowSize);
+    recording->numTicks++;
+}
+
+// Retorna os comandos gravados no tick, ou NULL depois do fim da gravação
+const Uint8 *getRecordedInputs(InputRecording *recording, int tick)
+{
+    if (tick < 0 || tick >= recording->numTicks)
+        return NULL;
+
+    return &recording->inputs[(size_t)tick * recording->config.numHelicopters];
+}
+
+bool saveInputRecording(InputRecording *recording, const char *path, Uint64 finalChecksum)
+{
+    int rowSize = recording->config.numHelicopters;
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        printf("Não foi possível criar a gravação %s\n", path);
+        return false;
+    }
+
+    InputRecordingHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = INPUT_RECORDING_MAGIC;
+    header.version = INPUT_RECORDING_VERSION;
+    header.config = recording->config;
+    header.numTicks = recording->numTicks;
+    header.finalChecksum = finalChecksum;
+
+    // o número de trechos só é conhecido no fim, então o cabeçalho é regravado
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (int tick = 0; tick < recording->numTicks && written;)
+    {
+        const Uint8 *row = getRecordedInputs(recording, tick);
+        Uint32 count = 1;
+        while (tick + (int)count < recording->numTicks && memcmp(getRecordedInputs(recording, tick + count), row, rowSize) == 0)
+            count++;
+
+        written = fwrite(&count, sizeof(count), 1, file) == 1 && fwrite(row, rowSize, 1, file) == 1;
+        header.numRuns++;
+        tick += count;
+    }
+
+    written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    written = fclose(file) == 0 && written;
+
+    if (!written)
+    {
+        printf("Erro ao gravar %s\n", path);
+        return false;
+    }
+
+    printf("Gravação: %d ticks (%.1f s) em %s, %d trechos, %ld bytes\n", recording->numTicks,
+           recording->numTicks * recording->config.tickTime / 1000.0, path, header.numRuns,
+           (long)(sizeof(header) + (size_t)header.numRuns * (sizeof(Uint32) + rowSize)));
+    return true;
+}
+
+bool loadInputRecording(InputRecording *recording, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        printf("Não foi possível abrir a gravação %s\n", path);
+        return false;
+    }
+
+    InputRecordingHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != INPUT_RECORDING_MAGIC ||
+        header.version != INPUT_RECORDING_VERSION || header.config.numHelicopters < 1 || header.numTicks < 0)
+    {
+        printf("%s não é uma gravação desta versão do jogo\n", path);
+        fclose(file);
+        return false;
+    }
+
+    initInputRecording(recording, &header.config);
+    recording->finalChecksum = header.finalChecksum;
+
+    int rowSize = header.config.numHelicopters;
+    Uint8 *row = (Uint8 *)malloc(rowSize);
+    bool valid = true;
+
+    for (int i = 0; i < header.numRuns && valid; i++)
+    {
+        Uint32 count;
+        valid = fread(&count, sizeof(count), 1, file) == 1 && fread(row, rowSize, 1, file) == 1 &&
+                recording->numTicks + (Sint64)count <= header.numTicks;
+        for (Uint32 j = 0; j < count && valid; j++)
+            recordInputs(recording, row);
+    }
+
+    free(row);
+    fclose(file);
+
+    if (!valid || recording->numTicks != header.numTicks)
+    {
+        printf("A gravação %s está incompleta\n", path);
+        freeInputRecording(recording);
+        return false;
+    }
+
+    return true;
+}
+
+// Confere se o replay terminou no mesmo estado da sessão gravada
+bool verifyInputRecording(InputRecording *recording, Uint64 finalChecksum)
+{
+    if (finalChecksum != recording->finalChecksum)
+    {
+        printf("Replay divergiu da gravação: estado final %016llx, esperado %016llx\n",
+               (unsigned long long)finalChecksum, (unsigned long long)recording->finalChecksum);
+        return false;
+    }
+
+    printf("Replay idêntico à gravação (estado final %016llx)\n", (unsigned long long)finalChecksum);
+    return true;
+}
@@ -0,0 +1,44 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef RECORDING_H
+#define RECORDING_H
+
+#define INPUT_RECORDING_MAGIC 0x56524a43 // "CJRV"
+#define INPUT_RECORDING_VERSION 2
+
+// Opções que definem uma sessão. O replay usa as da gravação no lugar das da linha de comando
+typedef struct
+{
+    Uint32 seed;
+    Sint32 difficulty;
+    Sint32 numCannons;
+    Sint32 numHelicopters;
+    Sint32 bridgeSegments;
+    Sint32 depotProducers;
+    Sint32 depotCapacity;
+    Sint32 tickTime; // ms
+} SessionConfig;
+
+// Comandos de todos os helicópteros em cada tick de uma sessão.
+// Na memória fica uma linha por tick; no arquivo, as linhas repetidas viram uma contagem
+typedef struct
+{
+    SessionConfig config;
+    Uint8 *inputs; // config.numHelicopters comandos por tick
+    int numTicks;
+    int capacity;  // em ticks
+    // resumo do estado no fim da sessão gravada, conferido no fim do replay
+    Uint64 finalChecksum;
+} InputRecording;
+
+void initInputRecording(InputRecording *recording, const SessionConfig *config);
+void freeInputRecording(InputRecording *recording);
+void recordInputs(InputRecording *recording, const Uint8 *inputs);
+const Uint8 *getRecordedInputs(InputRecording *recording, int tick);
+bool saveInputRecording(InputRecording *recording, const char *path, Uint64 finalChecksum);
+bool loadInputRecording(InputRecording *recording, const char *path);
+bool verifyInputRecording(InputRecording *recording, Uint64 finalChecksum);
+
+#endif /* RECORDING_H */
@@ -0,0 +1,305 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "rewind.h"
+#include "simulation.h"
+
+// Cada trecho do delta começa com um par de contagens em palavras de 8 bytes: quantas
+// palavras iguais ao quadro chave pular e quantas palavras novas vêm em seguida
+typedef struct
+{
+    Uint32 skip;
+    Uint32 literal;
+} RewindRun;
+
+static size_t alignRewindSize(size_t size)
+{
+    return (size + 7) & ~(size_t)7;
+}
+
+// Reserva memória pra guardar o estado de uma janela de seconds segundos, com um estado
+// a cada interval ticks. A área cabe dois quadros chave do maior tamanho possível pra cada
+// grupo de REWIND_KEYFRAME_INTERVAL estados; se os deltas forem maiores que isso, a janela
+// fica mais curta. Retorna false se a janela for inválida ou faltar memória
+bool initRewindBuffer(RewindBuffer *rewind, Simulation *simulation, int seconds, int interval)
+{
+    memset(rewind, 0, sizeof(RewindBuffer));
+    if (seconds < 1 || seconds > REWIND_MAX_SECONDS)
+    {
+        printf("A janela do retrocesso precisa ter de 1 a %d segundos\n", REWIND_MAX_SECONDS);
+        return false;
+    }
+
+    size_t maxStateSize = getMaxSaveStateSize(simulation);
+    rewind->interval = SDL_max(interval, 1);
+    // mais um grupo inteiro, já que os deltas saem junto com o quadro chave de que dependem
+    rewind->maxEntries = seconds * 1000 / (simulation->tuning.tickTime * rewind->interval) + 1 + REWIND_KEYFRAME_INTERVAL;
+    rewind->entries = (RewindEntry *)malloc(sizeof(RewindEntry) * rewind->maxEntries);
+
+    size_t keyframes = rewind->maxEntries / REWIND_KEYFRAME_INTERVAL + 1;
+    rewind->arenaSize = 2 * (keyframes + 1) * maxStateSize;
+    rewind->arena = (Uint8 *)malloc(rewind->arenaSize);
+
+    bool allocated = initSaveState(&rewind->current, maxStateSize);
+    allocated = initSaveState(&rewind->restored, maxStateSize) && allocated;
+    // o pior delta tem um par de contagens a cada duas palavras
+    rewind->delta = (Uint8 *)malloc(maxStateSize * 2 + sizeof(RewindRun));
+    rewind->keyframe = -1;
+
+    if (!allocated || rewind->entries == NULL || rewind->arena == NULL || rewind->delta == NULL)
+    {
+        printf("Falha ao alocar a área do retrocesso (%.1f MB)\n", rewind->arenaSize / (1024.0 * 1024.0));
+        destroyRewindBuffer(rewind);
+        return false;
+    }
+    return true;
+}
+
+void destroyRewindBuffer(RewindBuffer *rewind)
+{
+    free(rewind->arena);
+    free(rewind->entries);
+    free(rewind->delta);
+    freeSaveState(&rewind->current);
+    freeSaveState(&rewind->restored);
+}
+
+static RewindEntry *getRewindEntry(RewindBuffer *rewind, Sint64 sequence)
+{
+    return &rewind->entries[sequence % rewind->maxEntries];
+}
+
+// Palavra i do quadro chave, que conta como zero depois do fim dele
+static Uint64 getKeyframeWord(const Uint64 *keyframe, size_t keyframeWords, size_t i)
+{
+    return i < keyframeWords ? keyframe[i] : 0;
+}
+
+// Pula as palavras iguais ao quadro chave a partir de i, de 8 em 8 enquanto der
+static size_t skipEqualWords(const Uint64 *keyframe, size_t keyframeWords, const Uint64 *state, size_t stateWords, size_t i)
+{
+    size_t common = SDL_min(keyframeWords, stateWords);
+    while (i + 8 <= common)
+    {
+        Uint64 difference = 0;
+        for (int k = 0; k < 8; k++)
+            difference |= state[i + k] ^ keyframe[i + k];
+        if (difference != 0)
+            break;
+        i += 8;
+    }
+    while (i < stateWords && state[i] == getKeyframeWord(keyframe, keyframeWords, i))
+        i++;
+    return i;
+}
+
+// Monta em out as palavras do estado que mudaram em relação ao quadro chave. Uma palavra
+// igual no meio de duas diferentes vai junto com elas, pra não gastar um par de contagens
+static size_t encodeRewindDelta(const Uint64 *keyframe, size_t keyframeWords, const Uint64 *state, size_t stateWords, Uint8 *out)
+{
+    Uint8 *start = out;
+    size_t i = 0;
+
+    while (i < stateWords)
+    {
+        size_t skipStart = i;
+        i = skipEqualWords(keyframe, keyframeWords, state, stateWords, i);
+        if (i == stateWords)
+            break;
+
+        size_t literalStart = i;
+        while (i < stateWords && (state[i] != getKeyframeWord(keyframe, keyframeWords, i) ||
+                                  (i + 1 < stateWords && state[i + 1] != getKeyframeWord(keyframe, keyframeWords, i + 1))))
+            i++;
+
+        RewindRun run = {(Uint32)(literalStart - skipStart), (Uint32)(i - literalStart)};
+        memcpy(out, &run, sizeof(run));
+        out += sizeof(run);
+        memcpy(out, state + literalStart, run.literal * sizeof(Uint64));
+        out += run.literal * sizeof(Uint64);
+    }
+
+    return out - start;
+}
+
+// Reconstrói em state o estado da entrada: o quadro chave dela mais as palavras do delta
+static void decodeRewindEntry(RewindBuffer *rewind, RewindEntry *entry, SaveState *state)
+{
+    RewindEntry *keyframe = getRewindEntry(rewind, entry->keyframe);
+    size_t copied = SDL_min(keyframe->stateSize, entry->stateSize);
+    memcpy(state->data, rewind->arena + keyframe->offset, copied);
+    memset(state->data + copied, 0, entry->stateSize - copied);
+    state->size = entry->stateSize;
+
+    if (entry == keyframe)
+        return;
+
+    Uint64 *words = (Uint64 *)state->data;
+    const Uint8 *in = rewind->arena + entry->offset;
+    const Uint8 *end = in + entry->size;
+    size_t i = 0;
+    while (in < end)
+    {
+        RewindRun run;
+        memcpy(&run, in, sizeof(run));
+        in += sizeof(run);
+        i += run.skip;
+        memcpy(words + i, in, run.literal * sizeof(Uint64));
+        in += run.literal * sizeof(Uint64);
+        i += run.literal;
+    }
+}
+
+static void evictOldestRewindEntry(RewindBuffer *rewind)
+{
+    rewind->first++;
+    rewind->evicted++;
+
+    // deltas cujo quadro chave saiu não servem mais
+    while (rewind->first < rewind->next && getRewindEntry(rewind, rewind->first)->keyframe < rewind->first)
+    {
+        rewind->first++;
+        rewind->evicted++;
+    }
+}
+
+// Acha lugar pra size bytes na área, tirando os estados mais antigos do caminho.
+// Os estados ficam na área na ordem em que foram guardados, então os que estão à frente
+// de head são sempre os mais antigos
+static size_t reserveRewindSpace(RewindBuffer *rewind, size_t size)
+{
+    if (rewind->next - rewind->first == rewind->maxEntries)
+        evictOldestRewindEntry(rewind);
+
+    size_t offset = rewind->head;
+    if (offset + size > rewind->arenaSize)
+    {
+        // os que ficaram entre head e o fim da área saem antes de voltar pro começo
+        while (rewind->first < rewind->next && getRewindEntry(rewind, rewind->first)->offset >= offset)
+            evictOldestRewindEntry(rewind);
+        offset = 0;
+    }
+
+    while (rewind->first < rewind->next)
+    {
+        RewindEntry *oldest = getRewindEntry(rewind, rewind->first);
+        if (oldest->offset < offset || oldest->offset >= offset + size)
+            break;
+        evictOldestRewindEntry(rewind);
+    }
+
+    rewind->head = offset + alignRewindSize(size);
+    return offset;
+}
+
+// Chamado pela simulação no fim de cada tick: guarda o estado a cada interval ticks
+void recordRewindState(RewindBuffer *rewind, Simulation *simulation)
+{
+    if (simulation->tick % rewind->interval != 0)
+        return;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    SaveState *current = &rewind->current;
+    saveSimulationState(simulation, current);
+
+    // o delta é montado contra o quadro chave que está na área; se ficar maior que o
+    // próprio estado, ou o grupo já estiver cheio, o estado vira um quadro chave novo
+    bool keyframe = rewind->keyframe < rewind->first || rewind->next - rewind->keyframe >= REWIND_KEYFRAME_INTERVAL;
+    size_t deltaSize = 0;
+    if (!keyframe)
+    {
+        RewindEntry *base = getRewindEntry(rewind, rewind->keyframe);
+        deltaSize = encodeRewindDelta((const Uint64 *)(rewind->arena + base->offset), base->stateSize / sizeof(Uint64),
+                                      (const Uint64 *)current->data, current->size / sizeof(Uint64), rewind->delta);
+        keyframe = deltaSize >= current->size;
+    }
+
+    size_t offset = reserveRewindSpace(rewind, keyframe ? current->size : deltaSize);
+    // abrir espaço pode ter tirado o quadro chave do delta
+    if (!keyframe && rewind->keyframe < rewind->first)
+    {
+        keyframe = true;
+        offset = reserveRewindSpace(rewind, current->size);
+    }
+
+    Sint64 sequence = rewind->next++;
+    RewindEntry *entry = getRewindEntry(rewind, sequence);
+    entry->offset = offset;
+    entry->size = keyframe ? current->size : deltaSize;
+    entry->stateSize = current->size;
+    entry->tick = simulation->tick;
+    entry->keyframe = keyframe ? sequence : rewind->keyframe;
+    memcpy(rewind->arena + offset, keyframe ? current->data : rewind->delta, entry->size);
+
+    if (keyframe)
+    {
+        rewind->keyframe = sequence;
+        rewind->keyframes++;
+    }
+
+    rewind->saved++;
+    rewind->storedBytes += entry->size;
+    rewind->rawBytes += current->size;
+    rewind->saveTime += SDL_GetPerformanceCounter() - start;
+}
+
+// Tick do estado mais antigo guardado, ou -1 se não houver nenhum
+int getOldestRewindTick(RewindBuffer *rewind)
+{
+    return rewind->first < rewind->next ? getRewindEntry(rewind, rewind->first)->tick : -1;
+}
+
+// Volta a sessão pro último estado guardado até ticks ticks atrás (ou pro mais antigo, se
+// a janela não for tão longa). Os estados depois dele são descartados, já que a sessão
+// segue dali por outro caminho. Retorna o tick restaurado, ou -1 se não havia estado
+int rewindSimulation(RewindBuffer *rewind, Simulation *simulation, int ticks)
+{
+    if (rewind->first == rewind->next)
+        return -1;
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    int target = simulation->tick - ticks;
+
+    Sint64 sequence = rewind->next - 1;
+    while (sequence > rewind->first && getRewindEntry(rewind, sequence)->tick > target)
+        sequence--;
+
+    RewindEntry *entry = getRewindEntry(rewind, sequence);
+    decodeRewindEntry(rewind, entry, &rewind->restored);
+    if (!restoreSimulationState(simulation, &rewind->restored))
+        return -1;
+
+    rewind->next = sequence + 1;
+    rewind->head = entry->offset + alignRewindSize(entry->size);
+    rewind->keyframe = entry->keyframe;
+
+    rewind->restores++;
+    rewind->restoreTime += SDL_GetPerformanceCounter() - start;
+    return entry->tick;
+}
+
+void printRewindBufferStats(RewindBuffer *rewind, Simulation *simulation)
+{
+    if (rewind->saved == 0)
+        return;
+
+    double frequency = (double)SDL_GetPerformanceFrequency();
+    int covered = rewind->first < rewind->next ? getRewindEntry(rewind, rewind->next - 1)->tick - getOldestRewindTick(rewind) : 0;
+
+    printf("Retrocesso: %llu estados guardados (%llu quadros chave), %.0f bytes em média contra %.0f do estado inteiro\n",
+           (unsigned long long)rewind->saved,
+           (unsigned long long)rewind->keyframes,
+           (double)rewind->storedBytes / rewind->saved,
+           (double)rewind->rawBytes / rewind->saved);
+    printf("Retrocesso: %.2f us pra guardar um estado, área de %.1f MB cobrindo os últimos %.1f s, %llu estados descartados\n",
+           rewind->saveTime * 1e6 / frequency / rewind->saved,
+           rewind->arenaSize / (1024.0 * 1024.0),
+           covered * simulation->tuning.tickTime / 1000.0,
+           (unsigned long long)rewind->evicted);
+    if (rewind->restores > 0)
+        printf("Retrocesso: %llu restaurações, %.2f us em média\n",
+               (unsigned long long)rewind->restores,
+               rewind->restoreTime * 1e6 / frequency / rewind->restores);
+}
@@ -0,0 +1,69 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "savestate.h"
+
+#ifndef REWIND_H
+#define REWIND_H
+
+typedef struct Simulation Simulation;
+
+// Estados salvos dos últimos segundos da sessão, numa área de memória fixa alocada na
+// criação. Um estado a cada REWIND_KEYFRAME_INTERVAL fica inteiro (quadro chave); os outros
+// guardam só as palavras de 8 bytes que mudaram em relação ao último quadro chave, então
+// restaurar qualquer um é uma cópia do quadro chave mais as palavras do delta.
+// Quando a área ou o índice enchem, os estados mais antigos saem primeiro
+
+#define REWIND_KEYFRAME_INTERVAL 32
+// quanto a sessão volta quando o jogador pede pra tentar de novo
+#define REWIND_RETRY_TIME 2000 // ms
+// maior janela aceita; a área cresce com ela e com o tamanho máximo do estado
+#define REWIND_MAX_SECONDS 300
+
+typedef struct
+{
+    size_t offset; // posição na área
+    size_t size;   // bytes ocupados na área
+    size_t stateSize; // tamanho do estado que ele reconstrói
+    int tick;
+    Sint64 keyframe; // sequência do quadro chave de que ele depende (a própria, se for um)
+} RewindEntry;
+
+typedef struct
+{
+    Uint8 *arena;
+    size_t arenaSize;
+    size_t head; // onde o próximo estado é escrito
+
+    // índice circular pelas sequências dos estados: a entrada da sequência s fica em s % maxEntries
+    RewindEntry *entries;
+    int maxEntries;
+    Sint64 first;
+    Sint64 next;
+    // quadro chave atual, em relação ao qual os próximos deltas são montados
+    Sint64 keyframe;
+    int interval; // ticks entre dois estados guardados
+
+    SaveState current;
+    SaveState restored;
+    Uint8 *delta;
+
+    // Estatísticas
+    Uint64 saved;
+    Uint64 keyframes;
+    Uint64 storedBytes;
+    Uint64 rawBytes;
+    Uint64 evicted;
+    Uint64 saveTime;
+    Uint64 restores;
+    Uint64 restoreTime;
+} RewindBuffer;
+
+bool initRewindBuffer(RewindBuffer *rewind, Simulation *simulation, int seconds, int interval);
+void destroyRewindBuffer(RewindBuffer *rewind);
+void recordRewindState(RewindBuffer *rewind, Simulation *simulation);
+int rewindSimulation(RewindBuffer *rewind, Simulation *simulation, int ticks);
+int getOldestRewindTick(RewindBuffer *rewind);
+void printRewindBufferStats(RewindBuffer *rewind, Simulation *simulation);
+
+#endif /* REWIND_H */
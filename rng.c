@@ -0,0 +1,39 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "rng.h"
+
+#define PCG32_MULTIPLIER 6364136223846793005ULL
+
+void seedRandomStream(RandomStream *random, Uint64 seed, Uint64 stream)
+{
+    // o incremento precisa ser ímpar; sequências com incrementos diferentes não se sobrepõem
+    random->state = 0;
+    random->increment = (stream << 1) | 1;
+    nextRandom(random);
+    random->state += seed;
+    nextRandom(random);
+}
+
+Uint32 nextRandom(RandomStream *random)
+{
+    Uint64 state = random->state;
+    random->state = state * PCG32_MULTIPLIER + random->increment;
+
+    Uint32 xorShifted = (Uint32)(((state >> 18) ^ state) >> 27);
+    Uint32 rotation = (Uint32)(state >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+}
+
+// Número uniforme em [0, bound), descartando os valores que enviesariam o resto da divisão
+Uint32 nextRandomBelow(RandomStream *random, Uint32 bound)
+{
+    Uint32 threshold = (-bound) % bound;
+
+    for (;;)
+    {
+        Uint32 value = nextRandom(random);
+        if (value >= threshold)
+            return value % bound;
+    }
+}
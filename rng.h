@@ -0,0 +1,21 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef RNG_H
+#define RNG_H
+
+// Gerador PCG32 com estado próprio. Cada entidade tem a sua sequência, escolhida pela
+// semente da sessão e pelo índice da entidade, então o resultado não depende de qual
+// thread atualizou a entidade nem da ordem em que as entidades foram atualizadas
+typedef struct
+{
+    Uint64 state;
+    Uint64 increment;
+} RandomStream;
+
+void seedRandomStream(RandomStream *random, Uint64 seed, Uint64 stream);
+Uint32 nextRandom(RandomStream *random);
+Uint32 nextRandomBelow(RandomStream *random, Uint32 bound);
+
+#endif /* RNG_H */
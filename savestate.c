@@ -0,0 +1,562 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "savestate.h"
+#include "simulation.h"
+
+extern int NUM_HOSTAGES;
+
+// Campos da sessão que não pertencem a nenhuma entidade
+typedef struct
+{
+    Sint32 tick;
+    Sint32 currentHostages;
+    Sint32 rescuedHostages;
+    Sint32 destroyed;
+} SavedSession;
+
+// Canhões e helicópteros vão campo a campo numa struct zerada antes, pra que o
+// preenchimento entre os campos não mude de um estado pro outro e os estados de duas
+// sessões iguais sejam iguais byte a byte
+typedef struct
+{
+    SDL_Rect rect;
+    Sint32 speed;
+    Uint32 lastShotTime;
+    Sint32 ammunition;
+    Sint32 reloading;
+    Uint32 ticks;
+    Uint32 armedTicks;
+    BridgeReservation bridgeReservation;
+    RandomStream random;
+} SavedCannon;
+
+typedef struct
+{
+    SDL_Rect rect;
+    Sint32 speed;
+    Sint32 transportingHostage;
+    Sint32 destroyed;
+    Sint32 currentMovement;
+} SavedHelicopter;
+
+// Posições e contadores do anel do depósito; as células e os produtores vêm depois
+typedef struct
+{
+    Uint32 enqueuePosition;
+    Uint32 dequeuePosition;
+    Uint64 drawn;
+    Uint64 emptyDraws;
+} SavedDepot;
+
+// A ponte é salva a partir dos segmentos ocupados: o lock e as medidas não mudam na sessão
+#define SAVED_BRIDGE_OFFSET offsetof(Bridge, occupants)
+
+static const char *sectionNames[NUM_SAVE_STATE_SECTIONS] = {
+    "sessão", "canhões", "helicópteros", "ponte", "depósito", "mísseis"};
+
+// Cada seção começa alinhada em 8 bytes
+static size_t alignSaveStateOffset(size_t offset)
+{
+    return (offset + 7) & ~(size_t)7;
+}
+
+static size_t getDepotStateSize(AmmunitionDepot *depot)
+{
+    return sizeof(SavedDepot) + sizeof(AmmunitionCell) * (depot->ring.mask + 1) +
+           sizeof(AmmunitionProducer) * depot->numProducers;
+}
+
+// Tamanho do maior estado possível da sessão, com todos os slots de mísseis ocupados
+size_t getMaxSaveStateSize(Simulation *simulation)
+{
+    size_t size = alignSaveStateOffset(sizeof(SaveStateHeader));
+    size = alignSaveStateOffset(size + sizeof(SavedSession));
+    size = alignSaveStateOffset(size + (sizeof(SavedCannon) + sizeof(SDL_Rect)) * simulation->numCannons);
+    size = alignSaveStateOffset(size + (sizeof(SavedHelicopter) + sizeof(SDL_Rect)) * simulation->numHelicopters);
+    size = alignSaveStateOffset(size + sizeof(Bridge) - SAVED_BRIDGE_OFFSET);
+    size = alignSaveStateOffset(size + getDepotStateSize(&simulation->depot));
+    return alignSaveStateOffset(size + getMaxMissileSystemStateSize(&simulation->missileSystem));
+}
+
+bool initSaveState(SaveState *state, size_t capacity)
+{
+    state->data = (Uint8 *)calloc(capacity, 1);
+    state->size = 0;
+    state->capacity = state->data != NULL ? capacity : 0;
+    if (state->data == NULL)
+    {
+        printf("Falha ao alocar %zu bytes pro estado salvo\n", capacity);
+        return false;
+    }
+    return true;
+}
+
+void freeSaveState(SaveState *state)
+{
+    free(state->data);
+    state->data = NULL;
+    state->size = 0;
+    state->capacity = 0;
+}
+
+static Uint8 *saveBytes(Uint8 *out, const void *data, size_t size)
+{
+    memcpy(out, data, size);
+    return out + size;
+}
+
+// Começa uma seção, zerando o preenchimento até o alinhamento
+static Uint8 *beginSaveStateSection(SaveState *state, SaveStateHeader *header, SaveStateSection section, Uint8 *out)
+{
+    size_t offset = out - state->data;
+    size_t aligned = alignSaveStateOffset(offset);
+    memset(out, 0, aligned - offset);
+    header->sectionOffsets[section] = aligned;
+    return state->data + aligned;
+}
+
+// Copia o estado da sessão no fim do último tick. Precisa ser chamado entre dois ticks,
+// na thread da simulação (ou com ela parada). Não aloca nada: state precisa ter pelo
+// menos getMaxSaveStateSize bytes
+void saveSimulationState(Simulation *simulation, SaveState *state)
+{
+    SaveStateHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = SAVE_STATE_MAGIC;
+    header.version = SAVE_STATE_VERSION;
+    header.tick = simulation->tick;
+    header.config = simulation->config;
+
+    Uint8 *out = state->data + sizeof(header);
+
+    out = beginSaveStateSection(state, &header, SAVE_STATE_SESSION, out);
+    SavedSession session = {simulation->tick, simulation->currentHostages, simulation->rescuedHostages, simulation->destroyed};
+    out = saveBytes(out, &session, sizeof(session));
+
+    out = beginSaveStateSection(state, &header, SAVE_STATE_CANNONS, out);
+    for (int i = 0; i < simulation->numCannons; i++)
+    {
+        CannonInfo *cannon = &simulation->cannons[i];
+        SavedCannon saved;
+        memset(&saved, 0, sizeof(saved));
+        saved.rect = cannon->rect;
+        saved.speed = cannon->speed;
+        saved.lastShotTime = cannon->lastShotTime;
+        saved.ammunition = cannon->ammunition;
+        saved.reloading = cannon->reloading;
+        saved.ticks = cannon->ticks;
+        saved.armedTicks = cannon->armedTicks;
+        saved.bridgeReservation = cannon->bridgeReservation;
+        saved.random = cannon->random;
+        out = saveBytes(out, &saved, sizeof(saved));
+    }
+    out = saveBytes(out, simulation->previousCannonRects, sizeof(SDL_Rect) * simulation->numCannons);
+
+    out = beginSaveStateSection(state, &header, SAVE_STATE_HELICOPTERS, out);
+    for (int i = 0; i < simulation->numHelicopters; i++)
+    {
+        HelicopterInfo *helicopter = &simulation->helicopters[i];
+        SavedHelicopter saved;
+        memset(&saved, 0, sizeof(saved));
+        saved.rect = helicopter->rect;
+        saved.speed = helicopter->speed;
+        saved.transportingHostage = helicopter->transportingHostage;
+        saved.destroyed = helicopter->destroyed;
+        saved.currentMovement = helicopter->currentMovement;
+        out = saveBytes(out, &saved, sizeof(saved));
+    }
+    out = saveBytes(out, simulation->previousHelicopterRects, sizeof(SDL_Rect) * simulation->numHelicopters);
+
+    out = beginSaveStateSection(state, &header, SAVE_STATE_BRIDGE, out);
+    out = saveBytes(out, (Uint8 *)&simulation->bridge + SAVED_BRIDGE_OFFSET, sizeof(Bridge) - SAVED_BRIDGE_OFFSET);
+
+    out = beginSaveStateSection(state, &header, SAVE_STATE_DEPOT, out);
+    AmmunitionDepot *depot = &simulation->depot;
+    SavedDepot savedDepot = {depot->ring.enqueuePosition, depot->ring.dequeuePosition, depot->drawn, depot->emptyDraws};
+    out = saveBytes(out, &savedDepot, sizeof(savedDepot));
+    out = saveBytes(out, depot->ring.cells, sizeof(AmmunitionCell) * (depot->ring.mask + 1));
+    out = saveBytes(out, depot->producers, sizeof(AmmunitionProducer) * depot->numProducers);
+
+    out = beginSaveStateSection(state, &header, SAVE_STATE_MISSILES, out);
+    out += saveMissileSystemState(&simulation->missileSystem, out);
+
+    size_t size = out - state->data;
+    state->size = alignSaveStateOffset(size);
+    memset(out, 0, state->size - size);
+
+    header.size = state->size;
+    memcpy(state->data, &header, sizeof(header));
+}
+
+// Tamanho de uma seção, até o começo da próxima (ou o fim do estado)
+static size_t getSaveStateSectionSize(const SaveStateHeader *header, int section)
+{
+    size_t end = section + 1 < NUM_SAVE_STATE_SECTIONS ? header->sectionOffsets[section + 1] : header->size;
+    return end - header->sectionOffsets[section];
+}
+
+// Confere se o estado é desta versão, da mesma sessão e se as seções cabem nele
+static bool validateSaveState(Simulation *simulation, const SaveState *state, SaveStateHeader *header)
+{
+    if (state->size < sizeof(SaveStateHeader))
+        return false;
+    memcpy(header, state->data, sizeof(SaveStateHeader));
+
+    if (header->magic != SAVE_STATE_MAGIC || header->version != SAVE_STATE_VERSION || header->size != state->size)
+    {
+        printf("O estado salvo não é desta versão do jogo\n");
+        return false;
+    }
+    if (memcmp(&header->config, &simulation->config, sizeof(SessionConfig)) != 0)
+    {
+        printf("O estado salvo é de uma sessão com outras opções\n");
+        return false;
+    }
+
+    size_t fixedSizes[NUM_SAVE_STATE_SECTIONS] = {
+        sizeof(SavedSession),
+        (sizeof(SavedCannon) + sizeof(SDL_Rect)) * simulation->numCannons,
+        (sizeof(SavedHelicopter) + sizeof(SDL_Rect)) * simulation->numHelicopters,
+        sizeof(Bridge) - SAVED_BRIDGE_OFFSET,
+        getDepotStateSize(&simulation->depot),
+        0};
+    for (int i = 0; i < NUM_SAVE_STATE_SECTIONS; i++)
+    {
+        size_t offset = header->sectionOffsets[i];
+        size_t end = i + 1 < NUM_SAVE_STATE_SECTIONS ? header->sectionOffsets[i + 1] : header->size;
+        if (offset < sizeof(SaveStateHeader) || offset > end || end > header->size || end - offset < fixedSizes[i])
+        {
+            printf("O estado salvo está corrompido (seção %s)\n", sectionNames[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool isValidBridgeRange(Bridge *bridge, int first, int last)
+{
+    return first >= 0 && last < bridge->numSegments && first <= last + 1;
+}
+
+// Confere a ponte e as reservas dos canhões juntas: cada senha entre nowServing e
+// nextTicket de um sentido é de exatamente um canhão que ainda não entrou, e as filas
+// e os contadores batem com os estados das reservas. Uma senha sem dono pararia a fila
+// daquele sentido pra sempre
+static bool validateSavedBridge(Simulation *simulation, const SaveState *state, const SaveStateHeader *header)
+{
+    Bridge *bridge = &simulation->bridge;
+    int numCannons = simulation->numCannons;
+
+    // só os campos a partir de occupants vêm do estado; o número de segmentos é o da sessão
+    Bridge savedBridge;
+    memcpy((Uint8 *)&savedBridge + SAVED_BRIDGE_OFFSET, state->data + header->sectionOffsets[SAVE_STATE_BRIDGE],
+           sizeof(Bridge) - SAVED_BRIDGE_OFFSET);
+    for (int i = 0; i < BRIDGE_MAX_SEGMENTS; i++)
+    {
+        int maxOccupants = i < bridge->numSegments ? numCannons : 0;
+        if (savedBridge.occupants[i] < 0 || savedBridge.occupants[i] > maxOccupants)
+            return false;
+    }
+
+    unsigned int queueLength[2];
+    for (int queue = 0; queue < 2; queue++)
+    {
+        queueLength[queue] = savedBridge.nextTicket[queue] - savedBridge.nowServing[queue];
+        if (queueLength[queue] > (unsigned int)numCannons)
+            return false;
+    }
+
+    // uma marca por senha pendente, primeiro as do sentido 0
+    Uint8 *tickets = (Uint8 *)calloc(queueLength[0] + queueLength[1] + 1, 1);
+    if (tickets == NULL)
+        return false;
+
+    int pending[2] = {0, 0};
+    int waiting[2] = {0, 0};
+    int crossing = 0;
+    bool valid = true;
+    const Uint8 *in = state->data + header->sectionOffsets[SAVE_STATE_CANNONS];
+    for (int i = 0; i < numCannons && valid; i++)
+    {
+        SavedCannon saved;
+        memcpy(&saved, in + sizeof(saved) * i, sizeof(saved));
+        BridgeReservation *reservation = &saved.bridgeReservation;
+        if (saved.ammunition < 0 || saved.ammunition > simulation->tuning.ammunition ||
+            reservation->state < BRIDGE_IDLE || reservation->state > BRIDGE_CROSSING ||
+            !isValidBridgeRange(bridge, reservation->firstSegment, reservation->lastSegment))
+        {
+            valid = false;
+            break;
+        }
+
+        if (reservation->state == BRIDGE_CROSSING)
+            crossing++;
+        if (reservation->state != BRIDGE_RESERVED && reservation->state != BRIDGE_WAITING)
+            continue;
+
+        int queue = reservation->direction > 0 ? 1 : 0;
+        unsigned int position = reservation->ticket - savedBridge.nowServing[queue];
+        unsigned int mark = position + (queue == 1 ? queueLength[0] : 0);
+        valid = position < queueLength[queue] && !tickets[mark];
+        if (valid)
+            tickets[mark] = 1;
+        pending[queue]++;
+        if (reservation->state == BRIDGE_WAITING)
+            waiting[queue]++;
+    }
+    free(tickets);
+
+    for (int queue = 0; queue < 2; queue++)
+        valid = valid && pending[queue] == (int)queueLength[queue] && waiting[queue] == savedBridge.waiting[queue];
+    return valid && crossing == savedBridge.numCrossing;
+}
+
+// Confere o anel do depósito como ele fica entre dois ticks: as células entre
+// dequeuePosition e enqueuePosition estão prontas pra leitura (sequência da posição + 1)
+// e as outras livres pra próxima escrita (sequência da posição). Os produtores avançaram
+// até o início do último tick, now - tickTime, então a próxima fabricação de cada um vem
+// no máximo um intervalo de recarga depois disso
+static bool validateSavedDepot(Simulation *simulation, const SaveState *state, const SaveStateHeader *header, Uint32 now)
+{
+    AmmunitionDepot *depot = &simulation->depot;
+    unsigned int mask = depot->ring.mask;
+    const Uint8 *in = state->data + header->sectionOffsets[SAVE_STATE_DEPOT];
+
+    SavedDepot savedDepot;
+    memcpy(&savedDepot, in, sizeof(savedDepot));
+    in += sizeof(savedDepot);
+    unsigned int stored = savedDepot.enqueuePosition - savedDepot.dequeuePosition;
+    if (stored > mask + 1)
+        return false;
+
+    for (unsigned int i = 0; i <= mask; i++)
+    {
+        AmmunitionCell cell;
+        memcpy(&cell, in + sizeof(cell) * i, sizeof(cell));
+        unsigned int position = savedDepot.dequeuePosition + ((i - savedDepot.dequeuePosition) & mask);
+        bool full = position - savedDepot.dequeuePosition < stored;
+        if (cell.sequence != (full ? position + 1 : position) ||
+            (full && (cell.value < 0 || cell.value >= depot->numProducers)))
+            return false;
+    }
+    in += sizeof(AmmunitionCell) * (mask + 1);
+
+    for (int i = 0; i < depot->numProducers; i++)
+    {
+        AmmunitionProducer producer;
+        memcpy(&producer, in + sizeof(producer) * i, sizeof(producer));
+        Sint32 ahead = (Sint32)(producer.nextProductionTime - now);
+        if (ahead < -simulation->tuning.tickTime || ahead > (Sint32)depot->reloadTime)
+            return false;
+    }
+    return true;
+}
+
+// Confere os contadores e índices de cada seção de tamanho fixo antes de qualquer cópia:
+// reféns, helicópteros, ponte com as reservas dos canhões e depósito. Um arquivo
+// corrompido que passasse daqui escreveria fora dos arrays ou pararia a sessão nos próximos ticks
+static bool validateSavedEntities(Simulation *simulation, const SaveState *state, const SaveStateHeader *header)
+{
+    SavedSession session;
+    memcpy(&session, state->data + header->sectionOffsets[SAVE_STATE_SESSION], sizeof(session));
+    if (session.tick < 0 || session.currentHostages < 0 || session.rescuedHostages < 0 ||
+        session.currentHostages + session.rescuedHostages > NUM_HOSTAGES)
+        return false;
+
+    const Uint8 *in = state->data + header->sectionOffsets[SAVE_STATE_HELICOPTERS];
+    for (int i = 0; i < simulation->numHelicopters; i++)
+    {
+        SavedHelicopter saved;
+        memcpy(&saved, in + sizeof(saved) * i, sizeof(saved));
+        if (saved.currentMovement < 0 || saved.currentMovement > 2)
+            return false;
+    }
+
+    Uint32 now = simulation->startTime + (Uint32)session.tick * simulation->tuning.tickTime;
+    return validateSavedBridge(simulation, state, header) && validateSavedDepot(simulation, state, header, now);
+}
+
+// Volta a sessão pro estado salvo. Como saveSimulationState, só pode ser chamado entre
+// dois ticks. Retorna false, sem mudar nada, se o estado não for desta sessão
+bool restoreSimulationState(Simulation *simulation, const SaveState *state)
+{
+    SaveStateHeader header;
+    if (!validateSaveState(simulation, state, &header))
+        return false;
+    if (!validateSavedEntities(simulation, state, &header))
+    {
+        printf("O estado salvo está corrompido (contadores ou índices fora dos limites)\n");
+        return false;
+    }
+
+    // os mísseis são conferidos primeiro, porque é a única seção de tamanho variável
+    const Uint8 *missiles = state->data + header.sectionOffsets[SAVE_STATE_MISSILES];
+    if (!restoreMissileSystemState(&simulation->missileSystem, missiles, getSaveStateSectionSize(&header, SAVE_STATE_MISSILES)))
+    {
+        printf("O estado salvo está corrompido (seção %s)\n", sectionNames[SAVE_STATE_MISSILES]);
+        return false;
+    }
+
+    SavedSession session;
+    memcpy(&session, state->data + header.sectionOffsets[SAVE_STATE_SESSION], sizeof(session));
+    simulation->tick = session.tick;
+    simulation->now = simulation->startTime + (Uint32)simulation->tick * simulation->tuning.tickTime;
+    simulation->currentHostages = session.currentHostages;
+    simulation->rescuedHostages = session.rescuedHostages;
+    simulation->destroyed = session.destroyed;
+
+    const Uint8 *in = state->data + header.sectionOffsets[SAVE_STATE_CANNONS];
+    for (int i = 0; i < simulation->numCannons; i++)
+    {
+        CannonInfo *cannon = &simulation->cannons[i];
+        SavedCannon saved;
+        memcpy(&saved, in, sizeof(saved));
+        in += sizeof(saved);
+
+        cannon->rect = saved.rect;
+        cannon->speed = saved.speed;
+        cannon->lastShotTime = saved.lastShotTime;
+        cannon->ammunition = saved.ammunition;
+        cannon->reloading = saved.reloading;
+        cannon->ticks = saved.ticks;
+        cannon->armedTicks = saved.armedTicks;
+        cannon->bridgeReservation = saved.bridgeReservation;
+        cannon->random = saved.random;
+    }
+    memcpy(simulation->previousCannonRects, in, sizeof(SDL_Rect) * simulation->numCannons);
+
+    in = state->data + header.sectionOffsets[SAVE_STATE_HELICOPTERS];
+    for (int i = 0; i < simulation->numHelicopters; i++)
+    {
+        HelicopterInfo *helicopter = &simulation->helicopters[i];
+        SavedHelicopter saved;
+        memcpy(&saved, in, sizeof(saved));
+        in += sizeof(saved);
+
+        helicopter->rect = saved.rect;
+        helicopter->speed = saved.speed;
+        helicopter->transportingHostage = saved.transportingHostage;
+        helicopter->destroyed = saved.destroyed;
+        helicopter->currentMovement = saved.currentMovement;
+    }
+    memcpy(simulation->previousHelicopterRects, in, sizeof(SDL_Rect) * simulation->numHelicopters);
+
+    memcpy((Uint8 *)&simulation->bridge + SAVED_BRIDGE_OFFSET, state->data + header.sectionOffsets[SAVE_STATE_BRIDGE],
+           sizeof(Bridge) - SAVED_BRIDGE_OFFSET);
+
+    AmmunitionDepot *depot = &simulation->depot;
+    in = state->data + header.sectionOffsets[SAVE_STATE_DEPOT];
+    SavedDepot savedDepot;
+    memcpy(&savedDepot, in, sizeof(savedDepot));
+    in += sizeof(savedDepot);
+    depot->ring.enqueuePosition = savedDepot.enqueuePosition;
+    depot->ring.dequeuePosition = savedDepot.dequeuePosition;
+    depot->drawn = savedDepot.drawn;
+    depot->emptyDraws = savedDepot.emptyDraws;
+    memcpy(depot->ring.cells, in, sizeof(AmmunitionCell) * (depot->ring.mask + 1));
+    in += sizeof(AmmunitionCell) * (depot->ring.mask + 1);
+    memcpy(depot->producers, in, sizeof(AmmunitionProducer) * depot->numProducers);
+
+    return true;
+}
+
+bool writeSaveStateFile(const SaveState *state, const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        printf("Não foi possível criar o estado salvo %s\n", path);
+        return false;
+    }
+
+    bool written = fwrite(state->data, state->size, 1, file) == 1;
+    written = fclose(file) == 0 && written;
+    if (!written)
+    {
+        printf("Erro ao gravar %s\n", path);
+        return false;
+    }
+
+    printf("Estado do tick %d salvo em %s (%lu bytes)\n", ((SaveStateHeader *)state->data)->tick, path, (unsigned long)state->size);
+    return true;
+}
+
+// Lê um estado salvo. O estado é alocado com o tamanho do arquivo e só é conferido
+// contra a sessão em restoreSimulationState. O tamanho do cabeçalho precisa ser o do
+// arquivo, antes de qualquer alocação
+bool loadSaveStateFile(SaveState *state, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        printf("Não foi possível abrir o estado salvo %s\n", path);
+        return false;
+    }
+
+    long fileSize = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+        fileSize = ftell(file);
+    rewind(file);
+
+    SaveStateHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || header.magic != SAVE_STATE_MAGIC ||
+        header.version != SAVE_STATE_VERSION)
+    {
+        printf("%s não é um estado salvo desta versão do jogo\n", path);
+        fclose(file);
+        return false;
+    }
+    if (header.size < sizeof(header) || header.size > SAVE_STATE_MAX_SIZE || header.size % 8 != 0 ||
+        (long)header.size != fileSize)
+    {
+        printf("O estado salvo %s está corrompido (tamanho %u no cabeçalho, %ld no arquivo)\n", path, header.size, fileSize);
+        fclose(file);
+        return false;
+    }
+
+    if (!initSaveState(state, header.size))
+    {
+        fclose(file);
+        return false;
+    }
+    memcpy(state->data, &header, sizeof(header));
+    bool valid = fread(state->data + sizeof(header), header.size - sizeof(header), 1, file) == 1;
+    fclose(file);
+
+    if (!valid)
+    {
+        printf("O estado salvo %s está incompleto\n", path);
+        freeSaveState(state);
+        return false;
+    }
+
+    state->size = header.size;
+    return true;
+}
+
+// Primeira seção em que dois estados diferem, ou -1 se forem iguais. Serve pra achar
+// onde duas execuções que deveriam ser iguais se separaram
+int findSaveStateDifference(const SaveState *a, const SaveState *b)
+{
+    SaveStateHeader headerA, headerB;
+    memcpy(&headerA, a->data, sizeof(headerA));
+    memcpy(&headerB, b->data, sizeof(headerB));
+
+    for (int i = 0; i < NUM_SAVE_STATE_SECTIONS; i++)
+    {
+        size_t sizeA = getSaveStateSectionSize(&headerA, i);
+        if (sizeA != getSaveStateSectionSize(&headerB, i) ||
+            memcmp(a->data + headerA.sectionOffsets[i], b->data + headerB.sectionOffsets[i], sizeA) != 0)
+            return i;
+    }
+    return -1;
+}
+
+const char *getSaveStateSectionName(int section)
+{
+    return section >= 0 && section < NUM_SAVE_STATE_SECTIONS ? sectionNames[section] : "nenhuma";
+}
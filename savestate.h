@@ -0,0 +1,63 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "recording.h"
+
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+typedef struct Simulation Simulation;
+
+// Cópia binária de todo o estado que define o resto de uma sessão: canhões (munição, fase
+// da recarga, vez na ponte e números aleatórios), helicópteros, reféns, ponte, depósito e
+// mísseis. Restaurar e continuar dá exatamente os mesmos ticks que a sessão original.
+// O formato é o da memória (ordem de bytes e structs desta compilação), então salvar e
+// restaurar são só cópias; o arquivo serve pra mesma versão do jogo
+
+#define SAVE_STATE_MAGIC 0x53534a43 // "CJSS"
+#define SAVE_STATE_VERSION 1
+// Maior estado aceito de um arquivo, bem acima do de qualquer sessão
+#define SAVE_STATE_MAX_SIZE (64u << 20)
+
+// Seções do estado, na ordem em que aparecem. As de tamanho variável ficam no fim,
+// pra que as outras fiquem sempre na mesma posição e os deltas do retrocesso sejam pequenos
+typedef enum
+{
+    SAVE_STATE_SESSION,
+    SAVE_STATE_CANNONS,
+    SAVE_STATE_HELICOPTERS,
+    SAVE_STATE_BRIDGE,
+    SAVE_STATE_DEPOT,
+    SAVE_STATE_MISSILES,
+    NUM_SAVE_STATE_SECTIONS
+} SaveStateSection;
+
+typedef struct
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 size; // em bytes, com o cabeçalho; sempre múltiplo de 8
+    Sint32 tick;
+    SessionConfig config;
+    Uint32 sectionOffsets[NUM_SAVE_STATE_SECTIONS];
+    Uint32 reserved;
+} SaveStateHeader;
+
+typedef struct
+{
+    Uint8 *data;
+    size_t size;
+    size_t capacity;
+} SaveState;
+
+size_t getMaxSaveStateSize(Simulation *simulation);
+bool initSaveState(SaveState *state, size_t capacity);
+void freeSaveState(SaveState *state);
+void saveSimulationState(Simulation *simulation, SaveState *state);
+bool restoreSimulationState(Simulation *simulation, const SaveState *state);
+bool writeSaveStateFile(const SaveState *state, const char *path);
+bool loadSaveStateFile(SaveState *state, const char *path);
+int findSaveStateDifference(const SaveState *a, const SaveState *b);
+const char *getSaveStateSectionName(int section);
+
+#endif /* SAVESTATE_H */
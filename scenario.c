@@ -1,5 +1,4 @@
 #include <SDL2/SDL.h>
-#include <SDL2/SDL_image.h>
 #include <stdio.h>
 #include "scenario.h"
 
@@ -10,64 +9,62 @@ extern int SCREEN_WIDTH;
 extern int SCREEN_HEIGHT;
 extern int BUILDING_HEIGHT;
 extern int GROUND_HEIGHT;
+extern int BUILDING_WIDTH;
+extern int BRIDGE_WIDTH;
+extern int BRIDGE_HEIGHT;
 extern int MARGIN_BETWEEN_HOSTAGES;
+extern AssetAtlas assets;
 
 // Função pra criar um objeto do cenário
-ScenarioElementInfo createScenarioElement(int x, int y, int w, int h)
+ScenarioElementInfo createScenarioElement(int x, int y, int w, int h, SpriteId sprite)
 {
     ScenarioElementInfo rectInfo;
     rectInfo.rect.x = x;
     rectInfo.rect.y = y;
     rectInfo.rect.w = w;
     rectInfo.rect.h = h;
+    rectInfo.sprite = sprite;
     return rectInfo;
 }
 
-void drawExplosion(SDL_Renderer* renderer, int x, int y)
+// Cria os elementos do cenário
+void initScenario(Scenario *scenario)
 {
-    SDL_Surface* image = IMG_Load("sprites/explosion_spritesheet.png");
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, image);
-
-    for (int i = 0; i < 4; i++)
-    {
-        SDL_Rect srcrect = {i * 32, 0, 32, 32};
-        SDL_Rect dstrect = { x, y, EXPLOSION_SIZE, EXPLOSION_SIZE};
-        SDL_RenderCopy(renderer, texture, &srcrect, &dstrect);
-        SDL_RenderPresent(renderer);
-        SDL_Delay(100);
-    }
+    scenario->background = createScenarioElement(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, SPRITE_BACKGROUND);
+    scenario->ground = createScenarioElement(0, SCREEN_HEIGHT - GROUND_HEIGHT, SCREEN_WIDTH, GROUND_HEIGHT, SPRITE_GROUND);
+    scenario->bridge = createScenarioElement(BUILDING_WIDTH, SCREEN_HEIGHT - BRIDGE_HEIGHT, BRIDGE_WIDTH, BRIDGE_HEIGHT, SPRITE_BRIDGE);
+    scenario->leftBuilding = createScenarioElement(0, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT, BUILDING_WIDTH, BUILDING_HEIGHT, SPRITE_LEFT_BUILDING);
+    scenario->rightBuilding = createScenarioElement(SCREEN_WIDTH - BUILDING_WIDTH, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT, BUILDING_WIDTH, BUILDING_HEIGHT, SPRITE_RIGHT_BUILDING);
 }
 
-void drawHostages(SDL_Renderer* renderer, int capturedHostages, int rescuedHostages)
+// Desenha um dos 4 quadros da explosão
+void drawExplosion(RenderBatch* batch, int x, int y, int frame)
 {
-    SDL_Surface* image = IMG_Load("sprites/hostage_spritesheet.png");
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, image);
+    SDL_Rect srcrect = getSpriteFrame(&assets, SPRITE_EXPLOSION, frame, 0);
+    SDL_Rect dstrect = { x, y, EXPLOSION_SIZE, EXPLOSION_SIZE};
+    batchSprite(batch, &srcrect, &dstrect, 0, SDL_FLIP_NONE);
+}
 
+void drawHostages(RenderBatch* batch, int capturedHostages, int rescuedHostages)
+{
     // Desenha os reféns
     for (int i = 0; i < capturedHostages; i++)
     {
-        SDL_Rect srcrect = {0, 0, 12, 20};
+        SDL_Rect srcrect = getSpriteFrame(&assets, SPRITE_HOSTAGE, 0, 0);
         SDL_Rect dstrect = {(HOSTAGE_WIDTH + MARGIN_BETWEEN_HOSTAGES) * i, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT - HOSTAGE_HEIGHT, HOSTAGE_WIDTH, HOSTAGE_HEIGHT};
-        SDL_RenderCopy(renderer, texture, &srcrect, &dstrect);
+        batchSprite(batch, &srcrect, &dstrect, 0, SDL_FLIP_NONE);
     }
 
     for (int i = 0; i < rescuedHostages; i++)
     {
-        SDL_Rect srcrect = {0, 0, HOSTAGE_WIDTH, HOSTAGE_HEIGHT};
+        SDL_Rect srcrect = getSpriteFrame(&assets, SPRITE_HOSTAGE, 0, 0);
         SDL_Rect dstrect = {SCREEN_WIDTH - (HOSTAGE_WIDTH + MARGIN_BETWEEN_HOSTAGES) * (i + 1), SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT - HOSTAGE_HEIGHT, HOSTAGE_WIDTH, HOSTAGE_HEIGHT};
-        SDL_RenderCopyEx(renderer, texture, &srcrect, &dstrect, 0, NULL, SDL_FLIP_HORIZONTAL);
+        batchSprite(batch, &srcrect, &dstrect, 0, SDL_FLIP_HORIZONTAL);
     }
 }
 
-
-void loadScenarioSpritesheet(SDL_Renderer* renderer, ScenarioElementInfo *scenarioElement, char *spritesheet)
-{
-    SDL_Surface * image = IMG_Load(spritesheet);
-    scenarioElement->texture = SDL_CreateTextureFromSurface(renderer, image);
-}
-
-void drawScenarioElement(SDL_Renderer* renderer, ScenarioElementInfo* scenarioElement)
+void drawScenarioElement(RenderBatch* batch, ScenarioElementInfo* scenarioElement)
 {
-    SDL_Rect srcrect = {0, 0, scenarioElement->rect.w, scenarioElement->rect.h};
-    SDL_RenderCopy(renderer, scenarioElement->texture, &srcrect, &scenarioElement->rect);
+    SDL_Rect srcrect = getSpriteFrame(&assets, scenarioElement->sprite, 0, 0);
+    batchSprite(batch, &srcrect, &scenarioElement->rect, 0, SDL_FLIP_NONE);
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <SDL2/SDL.h>
 #include <stdio.h>
+#include "assets.h"
+#include "batch.h"
 
 #ifndef SCENARIO_H
 #define SCENARIO_H
@@ -7,14 +9,24 @@
 typedef struct
 {
     SDL_Rect rect;
-    SDL_Texture *texture;
+    SpriteId sprite;
 } ScenarioElementInfo;
 
-ScenarioElementInfo createScenarioElement(int x, int y, int w, int h);
-void drawExplosion(SDL_Renderer* renderer, int x, int y);
+// Elementos fixos do cenário de uma sessão
+typedef struct
+{
+    ScenarioElementInfo background;
+    ScenarioElementInfo ground;
+    ScenarioElementInfo bridge;
+    ScenarioElementInfo leftBuilding;
+    ScenarioElementInfo rightBuilding;
+} Scenario;
+
+ScenarioElementInfo createScenarioElement(int x, int y, int w, int h, SpriteId sprite);
+void initScenario(Scenario *scenario);
+void drawExplosion(RenderBatch* batch, int x, int y, int frame);
 
-void loadScenarioSpritesheet(SDL_Renderer* renderer, ScenarioElementInfo* scenarioElement, char* spritesheet);
-void drawHostages(SDL_Renderer* renderer, int capturedHostages, int rescuedHostages);
-void drawScenarioElement(SDL_Renderer* renderer, ScenarioElementInfo* scenarioElement);
+void drawHostages(RenderBatch* batch, int capturedHostages, int rescuedHostages);
+void drawScenarioElement(RenderBatch* batch, ScenarioElementInfo* scenarioElement);
 
 #endif /* SCENARIO_H */
\ No newline at end of file
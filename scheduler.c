@@ -0,0 +1,148 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "scheduler.h"
+#include "trace.h"
+
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+// Se a simulação atrasar mais que isso, os ticks que faltam são descartados
+// em vez de rodados todos de uma vez, pra que ela não fique presa tentando alcançar o relógio
+#define MAX_CATCH_UP_TICKS 5
+
+bool initTickScheduler(TickScheduler *scheduler, int periodMs)
+{
+    scheduler->frequency = SDL_GetPerformanceFrequency();
+    scheduler->period = scheduler->frequency * periodMs / 1000;
+    scheduler->lastWake = SDL_GetPerformanceCounter();
+    scheduler->nextDeadline = scheduler->lastWake + scheduler->period;
+    scheduler->timerFd = -1;
+    scheduler->usingTimerFd = false;
+
+    scheduler->wakeups = 0;
+    scheduler->ticks = 0;
+    scheduler->overruns = 0;
+    scheduler->droppedTicks = 0;
+    scheduler->totalWorkTime = 0;
+    scheduler->maxWorkTime = 0;
+    scheduler->maxLateness = 0;
+
+#ifdef __linux__
+    scheduler->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (scheduler->timerFd < 0)
+    {
+        printf("Não foi possível criar o timerfd, usando SDL_Delay\n");
+        return false;
+    }
+
+    struct itimerspec spec;
+    spec.it_interval.tv_sec = periodMs / 1000;
+    spec.it_interval.tv_nsec = (long)(periodMs % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(scheduler->timerFd, 0, &spec, NULL) < 0)
+    {
+        printf("Não foi possível programar o timerfd, usando SDL_Delay\n");
+        close(scheduler->timerFd);
+        scheduler->timerFd = -1;
+        return false;
+    }
+    scheduler->usingTimerFd = true;
+#endif
+
+    return true;
+}
+
+void destroyTickScheduler(TickScheduler *scheduler)
+{
+    if (scheduler->timerFd >= 0)
+        close(scheduler->timerFd);
+    scheduler->timerFd = -1;
+}
+
+// Bloqueia até o próximo tick e retorna quantos ticks a simulação deve avançar agora:
+// normalmente 1, ou mais se ela ficou pra trás
+int waitForNextTick(TickScheduler *scheduler)
+{
+    Uint64 due = 0;
+    Uint64 traceStart = traceBegin();
+
+#ifdef __linux__
+    if (scheduler->timerFd >= 0)
+    {
+        // o read retorna quantos períodos venceram desde a última leitura
+        uint64_t expirations = 0;
+        if (read(scheduler->timerFd, &expirations, sizeof(expirations)) == sizeof(expirations))
+            due = expirations;
+    }
+#endif
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (due == 0)
+    {
+        if (now < scheduler->nextDeadline)
+        {
+            SDL_Delay((Uint32)((scheduler->nextDeadline - now) * 1000 / scheduler->frequency));
+            now = SDL_GetPerformanceCounter();
+        }
+
+        due = 1;
+        if (now > scheduler->nextDeadline)
+            due += (now - scheduler->nextDeadline) / scheduler->period;
+        scheduler->nextDeadline += due * scheduler->period;
+    }
+
+    traceEnd("espera do tick", "escalonador", traceStart);
+
+    // atraso em relação ao período esperado desde o último tick
+    Uint64 expected = scheduler->lastWake + scheduler->period;
+    if (now > expected && now - expected > scheduler->maxLateness)
+        scheduler->maxLateness = now - expected;
+    scheduler->lastWake = now;
+
+    scheduler->wakeups++;
+    if (due > 1)
+        scheduler->overruns += due - 1;
+
+    if (due > MAX_CATCH_UP_TICKS)
+    {
+        scheduler->droppedTicks += due - MAX_CATCH_UP_TICKS;
+        due = MAX_CATCH_UP_TICKS;
+    }
+
+    return (int)due;
+}
+
+// Registra quanto tempo os ticks desse despertar levaram, medido a partir dele
+void recordTickWork(TickScheduler *scheduler, int ticks)
+{
+    Uint64 elapsed = SDL_GetPerformanceCounter() - scheduler->lastWake;
+
+    scheduler->ticks += ticks;
+    scheduler->totalWorkTime += elapsed;
+    if (elapsed > scheduler->maxWorkTime)
+        scheduler->maxWorkTime = elapsed;
+}
+
+void printTickSchedulerStats(TickScheduler *scheduler)
+{
+    if (scheduler->wakeups == 0)
+        return;
+
+    double toMs = 1000.0 / scheduler->frequency;
+    printf("\nEscalonador de ticks (%s): %llu ticks, período de %.1f ms\n",
+           scheduler->usingTimerFd ? "timerfd" : "SDL_Delay",
+           (unsigned long long)scheduler->ticks,
+           scheduler->period * toMs);
+    printf("Trabalho por tick: médio %.3f ms, pior %.3f ms (%.1f%% do período)\n",
+           scheduler->totalWorkTime * toMs / scheduler->wakeups,
+           scheduler->maxWorkTime * toMs,
+           100.0 * scheduler->maxWorkTime / scheduler->period);
+    printf("Atrasos: %llu ticks além do prazo, %llu descartados, pior atraso ao acordar %.3f ms\n",
+           (unsigned long long)scheduler->overruns,
+           (unsigned long long)scheduler->droppedTicks,
+           scheduler->maxLateness * toMs);
+}
@@ -0,0 +1,39 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+// Fonte central de ticks da simulação. No Linux usa um timerfd periódico, que conta
+// quantos períodos passaram desde a última espera; nos outros sistemas dorme até
+// um prazo absoluto. Os prazos seguem uma grade fixa, então o erro de uma espera
+// não se acumula nos ticks seguintes
+typedef struct
+{
+    int timerFd;
+    bool usingTimerFd;
+    Uint64 period; // em contagens do SDL_GetPerformanceCounter
+    Uint64 frequency;
+    Uint64 nextDeadline;
+    Uint64 lastWake;
+
+    // Estatísticas
+    Uint64 wakeups;
+    Uint64 ticks;
+    // ticks que começaram depois do prazo do tick seguinte
+    Uint64 overruns;
+    // ticks descartados porque o atraso passou do limite de recuperação
+    Uint64 droppedTicks;
+    Uint64 totalWorkTime;
+    Uint64 maxWorkTime;
+    Uint64 maxLateness;
+} TickScheduler;
+
+bool initTickScheduler(TickScheduler *scheduler, int periodMs);
+void destroyTickScheduler(TickScheduler *scheduler);
+int waitForNextTick(TickScheduler *scheduler);
+void recordTickWork(TickScheduler *scheduler, int ticks);
+void printTickSchedulerStats(TickScheduler *scheduler);
+
+#endif /* SCHEDULER_H */
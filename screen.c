@@ -0,0 +1,170 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "screen.h"
+
+extern int SCREEN_WIDTH;
+extern int SCREEN_HEIGHT;
+
+// Com regiões sujas, o renderizador por software desenha na própria superfície da janela,
+// que guarda o quadro anterior entre as apresentações
+SDL_Renderer *createScreenRenderer(SDL_Window *window, Uint32 flags, bool dirtyRects)
+{
+    if (!dirtyRects)
+        return SDL_CreateRenderer(window, -1, flags);
+
+    SDL_Surface *surface = SDL_GetWindowSurface(window);
+    if (surface == NULL)
+        return NULL;
+
+    return SDL_CreateSoftwareRenderer(surface);
+}
+
+void initScreen(Screen *screen, SDL_Window *window, SDL_Renderer *renderer, bool dirtyRects, ScenarioElementInfo **scenarioElements, int numScenarioElements)
+{
+    screen->window = window;
+    screen->renderer = renderer;
+    screen->staticLayer = NULL;
+    screen->scenarioElements = scenarioElements;
+    screen->numScenarioElements = numScenarioElements;
+    screen->dirtyRects = dirtyRects;
+    clearDirtyRects(&screen->previous);
+    clearDirtyRects(&screen->current);
+    // o primeiro quadro sempre é desenhado inteiro
+    screen->previous.full = true;
+    screen->frames = 0;
+    screen->fullFrames = 0;
+    screen->updatedPixels = 0;
+}
+
+void destroyScreen(Screen *screen)
+{
+    if (screen->staticLayer != NULL)
+        SDL_DestroyTexture(screen->staticLayer);
+    screen->staticLayer = NULL;
+}
+
+static void drawScenario(Screen *screen, RenderBatch *batch)
+{
+    for (int i = 0; i < screen->numScenarioElements; i++)
+        drawScenarioElement(batch, screen->scenarioElements[i]);
+    flushRenderBatch(batch);
+}
+
+// Desenha o cenário fixo uma única vez numa textura alvo.
+// Se o renderizador não suportar texturas alvo, o cenário continua sendo desenhado a cada quadro
+bool buildStaticLayer(Screen *screen, RenderBatch *batch)
+{
+    if (!SDL_RenderTargetSupported(screen->renderer))
+    {
+        printf("Renderizador sem texturas alvo, o cenário será desenhado a cada quadro\n");
+        return false;
+    }
+
+    screen->staticLayer = SDL_CreateTexture(screen->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if (screen->staticLayer == NULL || SDL_SetRenderTarget(screen->renderer, screen->staticLayer) != 0)
+    {
+        printf("Não foi possível criar a camada do cenário. Erro: %s\n", SDL_GetError());
+        destroyScreen(screen);
+        return false;
+    }
+
+    SDL_RenderClear(screen->renderer);
+    drawScenario(screen, batch);
+    SDL_SetRenderTarget(screen->renderer, NULL);
+    SDL_SetTextureBlendMode(screen->staticLayer, SDL_BLENDMODE_NONE);
+
+    return true;
+}
+
+// Desenha o fundo do quadro e começa a guardar as regiões tocadas pelos objetos
+void beginScreenFrame(Screen *screen, RenderBatch *batch)
+{
+    if (screen->staticLayer == NULL)
+    {
+        SDL_RenderClear(screen->renderer);
+        drawScenario(screen, batch);
+    }
+    else if (!screen->dirtyRects || screen->previous.full)
+    {
+        SDL_RenderCopy(screen->renderer, screen->staticLayer, NULL, NULL);
+    }
+    else
+    {
+        // apaga os objetos do quadro anterior
+        for (int i = 0; i < screen->previous.count; i++)
+            SDL_RenderCopy(screen->renderer, screen->staticLayer, &screen->previous.rects[i], &screen->previous.rects[i]);
+    }
+
+    if (screen->dirtyRects)
+    {
+        clearDirtyRects(&screen->current);
+        batch->dirty = &screen->current;
+    }
+}
+
+// Mostra o quadro. No modo de regiões sujas, atualiza na janela as regiões do quadro anterior
+// (onde os objetos foram apagados) e as do quadro atual (onde foram desenhados)
+void presentScreenFrame(Screen *screen, RenderBatch *batch)
+{
+    screen->frames++;
+
+    if (!screen->dirtyRects)
+    {
+        screen->fullFrames++;
+        screen->updatedPixels += (Uint64)SCREEN_WIDTH * SCREEN_HEIGHT;
+        SDL_RenderPresent(screen->renderer);
+        return;
+    }
+
+    batch->dirty = NULL;
+
+    DirtyRects updated = screen->current;
+    for (int i = 0; i < screen->previous.count; i++)
+        addDirtyRect(&updated, screen->previous.rects[i]);
+
+    if (screen->previous.full || updated.full)
+    {
+        presentFullScreen(screen);
+    }
+    else
+    {
+        SDL_Rect bounds = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+        for (int i = 0; i < updated.count; i++)
+        {
+            // a janela rejeita regiões fora da tela
+            SDL_IntersectRect(&updated.rects[i], &bounds, &updated.rects[i]);
+            screen->updatedPixels += (Uint64)updated.rects[i].w * updated.rects[i].h;
+        }
+        SDL_UpdateWindowSurfaceRects(screen->window, updated.rects, updated.count);
+    }
+
+    screen->previous = screen->current;
+}
+
+// Atualiza a janela inteira, usado no primeiro quadro, quando há regiões demais e pela explosão
+void presentFullScreen(Screen *screen)
+{
+    if (!screen->dirtyRects)
+    {
+        SDL_RenderPresent(screen->renderer);
+        return;
+    }
+
+    screen->fullFrames++;
+    screen->updatedPixels += (Uint64)SCREEN_WIDTH * SCREEN_HEIGHT;
+    SDL_UpdateWindowSurface(screen->window);
+    screen->previous.full = true;
+}
+
+void printScreenStats(Screen *screen)
+{
+    if (screen->frames == 0)
+        return;
+
+    printf("Tela: %s, %s, %llu de %llu quadros atualizados inteiros, %.1f%% da tela atualizada por quadro em média\n",
+           screen->staticLayer != NULL ? "cenário em cache" : "cenário redesenhado a cada quadro",
+           screen->dirtyRects ? "regiões sujas" : "quadros inteiros",
+           (unsigned long long)screen->fullFrames, (unsigned long long)screen->frames,
+           100.0 * screen->updatedPixels / ((double)screen->frames * SCREEN_WIDTH * SCREEN_HEIGHT));
+}
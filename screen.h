@@ -0,0 +1,42 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "batch.h"
+#include "scenario.h"
+
+#ifndef SCREEN_H
+#define SCREEN_H
+
+// Cuida do fundo de cada quadro e da apresentação.
+// O cenário fixo é composto uma única vez numa textura alvo e copiado inteiro a cada quadro.
+// No modo de regiões sujas, o renderizador por software desenha direto na superfície da janela,
+// e cada quadro só restaura do cenário as regiões ocupadas pelos objetos no quadro anterior
+// e só atualiza na janela as regiões que mudaram
+typedef struct
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *staticLayer;
+    ScenarioElementInfo **scenarioElements;
+    int numScenarioElements;
+
+    bool dirtyRects;
+    DirtyRects previous;
+    DirtyRects current;
+
+    // Estatísticas
+    Uint64 frames;
+    Uint64 fullFrames;
+    Uint64 updatedPixels;
+} Screen;
+
+SDL_Renderer *createScreenRenderer(SDL_Window *window, Uint32 flags, bool dirtyRects);
+void initScreen(Screen *screen, SDL_Window *window, SDL_Renderer *renderer, bool dirtyRects, ScenarioElementInfo **scenarioElements, int numScenarioElements);
+void destroyScreen(Screen *screen);
+bool buildStaticLayer(Screen *screen, RenderBatch *batch);
+void beginScreenFrame(Screen *screen, RenderBatch *batch);
+void presentScreenFrame(Screen *screen, RenderBatch *batch);
+void presentFullScreen(Screen *screen);
+void printScreenStats(Screen *screen);
+
+#endif /* SCREEN_H */
@@ -0,0 +1,172 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "script.h"
+#include "helicopter.h"
+
+// Roteiro usado quando nenhum arquivo é informado: vai e volta entre os prédios
+// na altura inicial, buscando um refém a cada viagem
+static HelicopterScriptStep defaultScriptSteps[] = {
+    {295, HELICOPTER_INPUT_LEFT},
+    {10, 0},
+    {296, HELICOPTER_INPUT_RIGHT},
+    {10, 0},
+    {1, HELICOPTER_INPUT_LEFT},
+};
+
+// Converte as letras L, R, U e D (ou "-" pra nenhuma tecla) nos bits de comando
+static Uint8 parseScriptKeys(const char *keys)
+{
+    Uint8 input = 0;
+
+    for (const char *c = keys; *c != '\0'; c++)
+    {
+        if (*c == 'L' || *c == 'l')
+            input |= HELICOPTER_INPUT_LEFT;
+        else if (*c == 'R' || *c == 'r')
+            input |= HELICOPTER_INPUT_RIGHT;
+        else if (*c == 'U' || *c == 'u')
+            input |= HELICOPTER_INPUT_UP;
+        else if (*c == 'D' || *c == 'd')
+            input |= HELICOPTER_INPUT_DOWN;
+    }
+
+    return input;
+}
+
+// Carrega um roteiro no formato "<ticks> <teclas>" por linha, ex: "50 LU".
+// Linhas vazias ou iniciadas por # são ignoradas. Sem arquivo, usa o roteiro padrão
+bool loadHelicopterScript(HelicopterScript *script, const char *path)
+{
+    script->steps = NULL;
+    script->numSteps = 0;
+    script->totalTicks = 0;
+
+    if (path == NULL)
+    {
+        int numSteps = sizeof(defaultScriptSteps) / sizeof(defaultScriptSteps[0]);
+        script->steps = (HelicopterScriptStep *)malloc(sizeof(defaultScriptSteps));
+        memcpy(script->steps, defaultScriptSteps, sizeof(defaultScriptSteps));
+        script->numSteps = numSteps;
+        for (int i = 0; i < numSteps; i++)
+            script->totalTicks += defaultScriptSteps[i].ticks;
+        return true;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("Não foi possível abrir o roteiro %s\n", path);
+        return false;
+    }
+
+    int capacity = 16;
+    script->steps = (HelicopterScriptStep *)malloc(sizeof(HelicopterScriptStep) * capacity);
+
+    char line[128];
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        int ticks;
+        char keys[64] = "";
+
+        if (line[0] == '#' || sscanf(line, "%d %63s", &ticks, keys) < 1 || ticks <= 0)
+            continue;
+
+        if (script->numSteps == capacity)
+        {
+            capacity *= 2;
+            script->steps = (HelicopterScriptStep *)realloc(script->steps, sizeof(HelicopterScriptStep) * capacity);
+        }
+
+        script->steps[script->numSteps].ticks = ticks;
+        script->steps[script->numSteps].input = parseScriptKeys(keys);
+        script->numSteps++;
+        script->totalTicks += ticks;
+    }
+
+    fclose(file);
+
+    if (script->numSteps == 0)
+    {
+        printf("O roteiro %s não tem nenhum comando\n", path);
+        freeHelicopterScript(script);
+        return false;
+    }
+
+    return true;
+}
+
+void freeHelicopterScript(HelicopterScript *script)
+{
+    free(script->steps);
+    script->steps = NULL;
+    script->numSteps = 0;
+    script->totalTicks = 0;
+}
+
+// Retorna os comandos do tick, repetindo o roteiro quando ele termina
+Uint8 getHelicopterScriptInput(HelicopterScript *script, int tick)
+{
+    int offset = tick % script->totalTicks;
+
+    for (int i = 0; i < script->numSteps; i++)
+    {
+        if (offset < script->steps[i].ticks)
+            return script->steps[i].input;
+        offset -= script->steps[i].ticks;
+    }
+
+    return 0;
+}
+
+// Deslocamento acumulado pelo roteiro depois de tick ticks, em passos do helicóptero
+static void getHelicopterScriptDisplacement(HelicopterScript *script, int tick, int *dx, int *dy)
+{
+    int loops = tick / script->totalTicks;
+    int offset = tick % script->totalTicks;
+    int loopX = 0, loopY = 0, x = 0, y = 0;
+
+    for (int i = 0; i < script->numSteps; i++)
+    {
+        Uint8 input = script->steps[i].input;
+        int stepX = ((input & HELICOPTER_INPUT_RIGHT) != 0) - ((input & HELICOPTER_INPUT_LEFT) != 0);
+        int stepY = ((input & HELICOPTER_INPUT_DOWN) != 0) - ((input & HELICOPTER_INPUT_UP) != 0);
+        int ticks = SDL_min(SDL_max(offset, 0), script->steps[i].ticks);
+
+        loopX += stepX * script->steps[i].ticks;
+        loopY += stepY * script->steps[i].ticks;
+        x += stepX * ticks;
+        y += stepY * ticks;
+        offset -= script->steps[i].ticks;
+    }
+
+    *dx = loops * loopX + x;
+    *dy = loops * loopY + y;
+}
+
+// Divide arredondando pra cima, também nos negativos
+static int divideRoundingUp(int value, int divisor)
+{
+    return value >= 0 ? (value + divisor - 1) / divisor : -(-value / divisor);
+}
+
+// Retorna os comandos de um tick que dura ticks ticks do roteiro, a partir de tick. Nesse
+// tick cada comando anda ticks vezes mais, então o helicóptero segue o deslocamento do
+// roteiro arredondado pra cima em múltiplos disso; o erro não se acumula de um tick pro
+// outro, mesmo que os trechos do roteiro não sejam múltiplos da duração do tick
+Uint8 getHelicopterScriptInputOver(HelicopterScript *script, int tick, int ticks)
+{
+    if (ticks <= 1)
+        return getHelicopterScriptInput(script, tick);
+
+    int startX, startY, endX, endY;
+    getHelicopterScriptDisplacement(script, tick, &startX, &startY);
+    getHelicopterScriptDisplacement(script, tick + ticks, &endX, &endY);
+    int moveX = divideRoundingUp(endX, ticks) - divideRoundingUp(startX, ticks);
+    int moveY = divideRoundingUp(endY, ticks) - divideRoundingUp(startY, ticks);
+
+    return (moveX < 0 ? HELICOPTER_INPUT_LEFT : 0) | (moveX > 0 ? HELICOPTER_INPUT_RIGHT : 0) |
+           (moveY < 0 ? HELICOPTER_INPUT_UP : 0) | (moveY > 0 ? HELICOPTER_INPUT_DOWN : 0);
+}
@@ -0,0 +1,27 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+// Um trecho do roteiro de comandos: mantém "input" pressionado por "ticks" ticks
+typedef struct
+{
+    int ticks;
+    Uint8 input;
+} HelicopterScriptStep;
+
+typedef struct
+{
+    HelicopterScriptStep *steps;
+    int numSteps;
+    int totalTicks;
+} HelicopterScript;
+
+bool loadHelicopterScript(HelicopterScript *script, const char *path);
+void freeHelicopterScript(HelicopterScript *script);
+Uint8 getHelicopterScriptInput(HelicopterScript *script, int tick);
+Uint8 getHelicopterScriptInputOver(HelicopterScript *script, int tick, int ticks);
+
+#endif /* SCRIPT_H */
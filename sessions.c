@@ -0,0 +1,173 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "sessions.h"
+#include "script.h"
+#include "trace.h"
+
+extern int NUM_HOSTAGES;
+
+typedef struct
+{
+    SessionBatchConfig *config;
+    HelicopterScript *script;
+    int index;
+    SessionResult *result;
+} SessionJob;
+
+// Roda uma sessão inteira dentro de um job. Cada sessão tem o seu próprio estado e
+// atualiza as fases em ordem, sem usar o pool, então o resultado só depende das opções.
+// A partida acaba como no jogo: quando o helicóptero do jogador é destruído ou todos
+// os reféns são resgatados
+static void runSessionJob(void *arg)
+{
+    SessionJob *job = (SessionJob *)arg;
+    SessionResult *result = job->result;
+
+    SessionConfig config = job->config->config;
+    config.seed += job->index;
+    if (job->config->sweepDifficulty)
+        config.difficulty = 1 + job->index % 3;
+
+    result->seed = config.seed;
+    result->difficulty = config.difficulty;
+    result->ticks = 0;
+    result->destroyedTick = -1;
+    result->rescuedAllTick = -1;
+    result->rescuedHostages = 0;
+    result->checksum = 0;
+
+    Simulation simulation;
+    result->failed = !initSimulation(&simulation, &config, NULL);
+    if (result->failed)
+        return;
+
+    Uint64 start = traceBegin();
+    while (simulation.tick < job->config->ticks)
+    {
+        fillScriptedHelicopterInputs(&simulation, job->script, 0);
+        stepSimulation(&simulation);
+
+        if (simulation.helicopters[0].destroyed)
+        {
+            result->destroyedTick = simulation.tick - 1;
+            break;
+        }
+        if (simulation.rescuedHostages == NUM_HOSTAGES)
+        {
+            result->rescuedAllTick = simulation.tick - 1;
+            break;
+        }
+    }
+    traceEnd("sessão", "sessões", start);
+
+    result->ticks = simulation.tick;
+    result->rescuedHostages = simulation.rescuedHostages;
+    result->checksum = hashSimulationState(&simulation);
+
+    destroySimulation(&simulation);
+}
+
+// Soma dos resultados das sessões de uma dificuldade
+typedef struct
+{
+    int sessions;
+    int destroyed;
+    Uint64 destroyedTicks;
+    int won;
+    Uint64 wonTicks;
+    int rescuedHostages;
+} SessionSummary;
+
+// Roda todas as sessões do lote como jobs no pool (no máximo uma por thread ao mesmo tempo)
+// e mostra a vazão e o resultado agregado de cada dificuldade
+int runSessionBatch(SessionBatchConfig *config, JobPool *pool)
+{
+    HelicopterScript script;
+    if (!loadHelicopterScript(&script, config->scriptPath))
+        return 1;
+
+    SessionJob *jobs = (SessionJob *)malloc(sizeof(SessionJob) * config->numSessions);
+    SessionResult *results = (SessionResult *)malloc(sizeof(SessionResult) * config->numSessions);
+
+    Uint64 wallStart = SDL_GetPerformanceCounter();
+
+    for (int i = 0; i < config->numSessions; i++)
+    {
+        jobs[i].config = config;
+        jobs[i].script = &script;
+        jobs[i].index = i;
+        jobs[i].result = &results[i];
+        submitJob(pool, runSessionJob, &jobs[i]);
+    }
+    waitJobPool(pool);
+
+    double wallTime = (double)(SDL_GetPerformanceCounter() - wallStart) / SDL_GetPerformanceFrequency();
+
+    // o resumo do lote combina os estados finais na ordem das sessões, então é o mesmo
+    // com qualquer número de threads
+    SessionSummary summaries[4] = {{0}};
+    Uint64 totalTicks = 0;
+    Uint64 batchChecksum = 14695981039346656037ULL;
+    int failed = 0;
+    for (int i = 0; i < config->numSessions; i++)
+    {
+        SessionResult *result = &results[i];
+        if (result->failed)
+        {
+            failed++;
+            continue;
+        }
+
+        SessionSummary *summary = &summaries[result->difficulty];
+        summary->sessions++;
+        summary->rescuedHostages += result->rescuedHostages;
+        if (result->destroyedTick >= 0)
+        {
+            summary->destroyed++;
+            summary->destroyedTicks += result->destroyedTick;
+        }
+        if (result->rescuedAllTick >= 0)
+        {
+            summary->won++;
+            summary->wonTicks += result->rescuedAllTick;
+        }
+
+        totalTicks += result->ticks;
+        batchChecksum = (batchChecksum ^ result->checksum) * 1099511628211ULL;
+    }
+
+    int tickTime = config->config.tickTime;
+    printf("Lote de %d sessões: %d canhões e %d helicópteros cada, até %d ticks de %d ms\n",
+           config->numSessions, config->config.numCannons, config->config.numHelicopters, config->ticks, tickTime);
+    printf("%llu ticks simulados em %.3f s de relógio, com %d threads\n",
+           (unsigned long long)totalTicks, wallTime, pool->numQueues);
+    if (wallTime > 0)
+        printf("Vazão: %.1f sessões/s, %.0f ticks/s\n", config->numSessions / wallTime, totalTicks / wallTime);
+
+    for (int difficulty = 1; difficulty <= 3; difficulty++)
+    {
+        SessionSummary *summary = &summaries[difficulty];
+        if (summary->sessions == 0)
+            continue;
+
+        printf("Dificuldade %d: %d sessões, helicóptero destruído em %.1f%%", difficulty, summary->sessions,
+               100.0 * summary->destroyed / summary->sessions);
+        if (summary->destroyed > 0)
+            printf(" (em média aos %.1f s)", (double)summary->destroyedTicks / summary->destroyed * tickTime / 1000.0);
+        printf(", todos os reféns resgatados em %.1f%%", 100.0 * summary->won / summary->sessions);
+        if (summary->won > 0)
+            printf(" (em média aos %.1f s)", (double)summary->wonTicks / summary->won * tickTime / 1000.0);
+        printf(", %.2f reféns resgatados por sessão\n", (double)summary->rescuedHostages / summary->sessions);
+    }
+
+    if (failed > 0)
+        printf("%d sessões não puderam ser criadas\n", failed);
+    printf("Resumo do lote: %016llx\n", (unsigned long long)batchChecksum);
+
+    free(jobs);
+    free(results);
+    freeHelicopterScript(&script);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "simulation.h"
+#include "jobs.h"
+
+#ifndef SESSIONS_H
+#define SESSIONS_H
+
+// Lote de sessões sem janela, independentes, rodadas em paralelo no pool de threads.
+// A sessão i usa a semente config.seed + i e, com sweepDifficulty, a dificuldade 1 + i % 3
+typedef struct
+{
+    SessionConfig config;
+    int numSessions;
+    int ticks;              // limite de ticks de cada sessão
+    const char *scriptPath; // NULL usa o roteiro padrão
+    bool sweepDifficulty;
+} SessionBatchConfig;
+
+// Resultado de uma sessão do lote
+typedef struct
+{
+    Uint32 seed;
+    int difficulty;
+    bool failed;
+    int ticks;          // ticks simulados até o fim da partida ou até o limite
+    int destroyedTick;  // -1 se o helicóptero do jogador não foi destruído
+    int rescuedAllTick; // -1 se nem todos os reféns foram resgatados
+    int rescuedHostages;
+    Uint64 checksum;
+} SessionResult;
+
+int runSessionBatch(SessionBatchConfig *config, JobPool *pool);
+
+#endif /* SESSIONS_H */
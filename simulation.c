@@ -0,0 +1,495 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "simulation.h"
+#include "scenario.h"
+#include "depot.h"
+#include "trace.h"
+
+extern int SCREEN_WIDTH;
+extern int SCREEN_HEIGHT;
+extern int GROUND_HEIGHT;
+extern int BUILDING_WIDTH;
+extern int BUILDING_HEIGHT;
+extern int BRIDGE_WIDTH;
+extern int BRIDGE_HEIGHT;
+extern int CANNON_WIDTH;
+extern int CANNON_HEIGHT;
+extern int HELICOPTER_WIDTH;
+extern int HELICOPTER_HEIGHT;
+extern int NUM_HOSTAGES;
+extern int MAX_MISSILES;
+extern int CANNON_SPEED;
+extern int HELICOPTER_SPEED;
+extern int MISSILE_SPEED;
+extern int BASE_SIMULATION_TICK_TIME;
+extern int AMMUNITION;
+extern int RELOAD_TIME_FOR_EACH_MISSILE;
+extern int MIN_COOLDOWN_TIME;
+extern int MAX_COOLDOWN_TIME;
+
+// Ticks de defasagem entre os roteiros de helicópteros vizinhos, pra que não voem sobrepostos
+#define SCRIPT_OFFSET_PER_HELICOPTER 50
+
+// Ajusta os parâmetros base à dificuldade (1 a 3) e à duração do tick. Em ticks mais longos
+// cada passo anda mais; as colisões dos mísseis são contínuas, então nada é atravessado
+static void initGameTuning(GameTuning *tuning, int difficulty, int tickTime)
+{
+    int baseTicksPerTick = tickTime / BASE_SIMULATION_TICK_TIME;
+
+    tuning->ammunition = AMMUNITION * (0.5 * difficulty + 0.5);
+    tuning->reloadTimeForEachMissile = RELOAD_TIME_FOR_EACH_MISSILE / difficulty;
+    tuning->minCooldownTime = MIN_COOLDOWN_TIME / difficulty;
+    tuning->maxCooldownTime = MAX_COOLDOWN_TIME / difficulty;
+    tuning->tickTime = tickTime;
+    tuning->cannonSpeed = CANNON_SPEED * baseTicksPerTick;
+    tuning->helicopterSpeed = HELICOPTER_SPEED * baseTicksPerTick;
+    tuning->missileSpeed = MISSILE_SPEED * baseTicksPerTick;
+}
+
+// Cria uma sessão a partir das suas opções: o cenário, a ponte, o depósito, os mísseis,
+// os canhões e helicópteros, e registra os obstáculos na grade de colisão.
+// A semente define a sequência de números aleatórios de cada canhão.
+// Os valores padrão do depósito (negativos na configuração) são resolvidos aqui e
+// ficam em simulation->config
+bool initSimulation(Simulation *simulation, const SessionConfig *config, JobPool *jobPool)
+{
+    int numCannons = config->numCannons;
+    int numHelicopters = config->numHelicopters;
+
+    if (numCannons < 0 || numHelicopters < 1)
+    {
+        printf("É preciso ao menos um helicóptero e um número não negativo de canhões\n");
+        return false;
+    }
+    if (config->difficulty < 1 || config->difficulty > 3)
+    {
+        printf("Dificuldade inválida: %d\n", config->difficulty);
+        return false;
+    }
+    if (config->tickTime <= 0 || config->tickTime % BASE_SIMULATION_TICK_TIME != 0)
+    {
+        printf("A duração do tick precisa ser um múltiplo positivo de %d ms\n", BASE_SIMULATION_TICK_TIME);
+        return false;
+    }
+
+    simulation->config = *config;
+    initGameTuning(&simulation->tuning, config->difficulty, config->tickTime);
+
+    // Por padrão o depósito tem um produtor por canhão, a mesma vazão da recarga original,
+    // e guarda duas cargas completas
+    if (simulation->config.depotProducers < 0)
+        simulation->config.depotProducers = numCannons;
+    if (simulation->config.depotCapacity <= 0)
+        simulation->config.depotCapacity = 2 * simulation->tuning.ammunition;
+    // sem produtores, os canhões esperariam no depósito pra sempre. A conferência vale pra
+    // qualquer origem da configuração (linha de comando, gravação, estado salvo ou ambiente)
+    if (numCannons > 0 && simulation->config.depotProducers < 1)
+    {
+        printf("O depósito precisa de ao menos um produtor quando há canhões\n");
+        return false;
+    }
+
+    // o relógio da simulação é virtual e começa sempre em 0, pra que as sessões se repitam
+    simulation->startTime = 0;
+    simulation->now = simulation->startTime;
+    if (!initAmmunitionDepot(&simulation->depot, simulation->config.depotProducers, simulation->config.depotCapacity,
+                             simulation->tuning.reloadTimeForEachMissile, simulation->startTime))
+        return false;
+
+    initScenario(&simulation->scenario);
+    // A ponte é atravessada pelos canhões na ordem em que reservam a vez
+    initBridge(&simulation->bridge, BUILDING_WIDTH, BRIDGE_WIDTH, config->bridgeSegments);
+    initMissileSystem(&simulation->missileSystem, MAX_MISSILES, simulation->tuning.missileSpeed);
+
+    pthread_mutex_init(&simulation->hostagesMutex, NULL);
+    simulation->currentHostages = NUM_HOSTAGES;
+    simulation->rescuedHostages = 0;
+    simulation->destroyed = false;
+
+    simulation->numCannons = numCannons;
+    simulation->numHelicopters = numHelicopters;
+    simulation->cannons = (CannonInfo *)malloc(sizeof(CannonInfo) * numCannons);
+    simulation->helicopters = (HelicopterInfo *)malloc(sizeof(HelicopterInfo) * numHelicopters);
+    simulation->previousCannonRects = (SDL_Rect *)malloc(sizeof(SDL_Rect) * numCannons);
+    simulation->previousHelicopterRects = (SDL_Rect *)malloc(sizeof(SDL_Rect) * numHelicopters);
+    simulation->helicopterInputs = (Uint8 *)calloc(numHelicopters, sizeof(Uint8));
+    initInputQueue(&simulation->input);
+    simulation->jobPool = jobPool;
+    simulation->tick = 0;
+    simulation->running = true;
+    simulation->recorder = NULL;
+    simulation->replay = NULL;
+    simulation->deterministic = false;
+    simulation->spectators = NULL;
+    simulation->rewind = NULL;
+    simulation->rewindRequests = 0;
+    simulation->rewindsDone = 0;
+    for (int i = 0; i < NUM_SIMULATION_PHASES; i++)
+        simulation->phaseTime[i] = 0;
+    simulation->scheduler.wakeups = 0;
+
+    // até 4 jobs por thread em cada fase, pra que quem terminar antes roube o resto
+    simulation->maxJobs = jobPool != NULL ? jobPool->numQueues * 4 : 1;
+    simulation->jobs = (SimulationJob *)malloc(sizeof(SimulationJob) * simulation->maxJobs);
+
+    CollisionWorld *collisionWorld = &simulation->collisionWorld;
+    initCollisionWorld(collisionWorld, numCannons + 3);
+
+    // Os canhões começam espalhados entre a ponte e o prédio da direita.
+    // Os dois primeiros ficam nas mesmas posições da versão original do jogo
+    int slots = (SCREEN_WIDTH - 2 * BUILDING_WIDTH - BRIDGE_WIDTH) / CANNON_WIDTH;
+    for (int i = 0; i < numCannons; i++)
+    {
+        int slot = ((2 - i) % slots + slots) % slots;
+        simulation->cannons[i] = createCannon(BUILDING_WIDTH + BRIDGE_WIDTH + CANNON_WIDTH * slot, SCREEN_HEIGHT - BRIDGE_HEIGHT - CANNON_HEIGHT, CANNON_WIDTH, CANNON_HEIGHT, 0, simulation->tuning.cannonSpeed);
+        simulation->cannons[i].lastShotTime = simulation->startTime;
+        seedRandomStream(&simulation->cannons[i].random, config->seed, i);
+        addCollisionObstacle(collisionWorld, &simulation->cannons[i].rect);
+    }
+
+    addCollisionObstacle(collisionWorld, &simulation->scenario.ground.rect);
+    addCollisionObstacle(collisionWorld, &simulation->scenario.leftBuilding.rect);
+    addCollisionObstacle(collisionWorld, &simulation->scenario.rightBuilding.rect);
+
+    for (int i = 0; i < numHelicopters; i++)
+    {
+        simulation->helicopters[i] = createHelicopter(SCREEN_WIDTH - BUILDING_WIDTH, SCREEN_HEIGHT - BUILDING_HEIGHT - GROUND_HEIGHT - HELICOPTER_HEIGHT * 1.5, HELICOPTER_WIDTH, HELICOPTER_HEIGHT, simulation->tuning.helicopterSpeed);
+        simulation->previousHelicopterRects[i] = simulation->helicopters[i].rect;
+    }
+
+    for (int i = 0; i < numCannons; i++)
+        simulation->previousCannonRects[i] = simulation->cannons[i].rect;
+
+    initSnapshotTripleBuffer(&simulation->snapshots, numCannons, numHelicopters, simulation->missileSystem.capacity);
+    return true;
+}
+
+void destroySimulation(Simulation *simulation)
+{
+    free(simulation->cannons);
+    free(simulation->helicopters);
+    free(simulation->previousCannonRects);
+    free(simulation->previousHelicopterRects);
+    free(simulation->helicopterInputs);
+    free(simulation->jobs);
+    destroySnapshotTripleBuffer(&simulation->snapshots);
+    destroyCollisionWorld(&simulation->collisionWorld);
+    destroyMissileSystem(&simulation->missileSystem);
+    destroyBridge(&simulation->bridge);
+    destroyAmmunitionDepot(&simulation->depot);
+    pthread_mutex_destroy(&simulation->hostagesMutex);
+}
+
+// Preenche os comandos dos helicópteros a partir do roteiro, cada um defasado do anterior
+void fillScriptedHelicopterInputs(Simulation *simulation, HelicopterScript *script, int firstHelicopter)
+{
+    // o roteiro é contado em ticks base, então segue o mesmo no tempo com qualquer --tick-ms
+    int baseTicksPerTick = simulation->tuning.tickTime / BASE_SIMULATION_TICK_TIME;
+    int baseTick = simulation->tick * baseTicksPerTick;
+    for (int i = firstHelicopter; i < simulation->numHelicopters; i++)
+        simulation->helicopterInputs[i] = getHelicopterScriptInputOver(script, baseTick + i * SCRIPT_OFFSET_PER_HELICOPTER, baseTicksPerTick);
+}
+
+static void helicopterJob(void *arg)
+{
+    SimulationJob *job = (SimulationJob *)arg;
+    Simulation *simulation = job->simulation;
+
+    for (int i = job->begin; i < job->end; i++)
+        stepHelicopter(simulation, &simulation->helicopters[i], simulation->helicopterInputs[i]);
+}
+
+static void depotJob(void *arg)
+{
+    SimulationJob *job = (SimulationJob *)arg;
+
+    for (int i = job->begin; i < job->end; i++)
+        stepAmmunitionProducer(&job->simulation->depot, i, job->simulation->now);
+}
+
+static void cannonJob(void *arg)
+{
+    SimulationJob *job = (SimulationJob *)arg;
+    Simulation *simulation = job->simulation;
+
+    for (int i = job->begin; i < job->end; i++)
+    {
+        stepCannon(simulation, &simulation->cannons[i]);
+        stepCannonReload(simulation, &simulation->cannons[i]);
+    }
+}
+
+// Divide as entidades em jobs, roda todos no pool e espera a fase terminar
+static void runSimulationPhase(Simulation *simulation, JobFunction function, int numEntities)
+{
+    if (numEntities == 0)
+        return;
+
+    int numJobs = SDL_min(numEntities, simulation->maxJobs);
+
+    // sem pool ou com um job só, não vale a pena passar pelas filas
+    if (simulation->jobPool == NULL || numJobs == 1 || simulation->deterministic)
+    {
+        SimulationJob job = {simulation, 0, numEntities};
+        function(&job);
+        return;
+    }
+
+    for (int j = 0; j < numJobs; j++)
+    {
+        simulation->jobs[j].simulation = simulation;
+        simulation->jobs[j].begin = numEntities * j / numJobs;
+        simulation->jobs[j].end = numEntities * (j + 1) / numJobs;
+        submitJob(simulation->jobPool, function, &simulation->jobs[j]);
+    }
+
+    waitJobPool(simulation->jobPool);
+}
+
+static const char *simulationPhaseNames[NUM_SIMULATION_PHASES] = {
+    "grade de colisão",
+    "helicópteros",
+    "depósito",
+    "canhões",
+    "mísseis",
+};
+
+static void traceSimulationPhase(SimulationPhase phase, Uint64 start, Uint64 end)
+{
+    if (tracingEnabled)
+        recordTraceEvent(simulationPhaseNames[phase], "simulação", start, end);
+}
+
+// Avança toda a simulação em um tick. Os comandos dos helicópteros devem estar preenchidos.
+// Cada fase só lê o que as fases anteriores escreveram, então os jobs de uma fase não competem
+void stepSimulation(Simulation *simulation)
+{
+    simulation->now = simulation->startTime + (Uint32)simulation->tick * simulation->tuning.tickTime;
+
+    // no replay, os comandos gravados substituem os do teclado e do roteiro
+    if (simulation->replay != NULL)
+    {
+        const Uint8 *inputs = getRecordedInputs(simulation->replay, simulation->tick);
+        if (inputs != NULL)
+            memcpy(simulation->helicopterInputs, inputs, simulation->numHelicopters);
+        else
+            memset(simulation->helicopterInputs, 0, simulation->numHelicopters);
+    }
+    if (simulation->recorder != NULL)
+        recordInputs(simulation->recorder, simulation->helicopterInputs);
+
+    for (int i = 0; i < simulation->numCannons; i++)
+        simulation->previousCannonRects[i] = simulation->cannons[i].rect;
+    for (int i = 0; i < simulation->numHelicopters; i++)
+        simulation->previousHelicopterRects[i] = simulation->helicopters[i].rect;
+
+    Uint64 tickStart = traceBegin();
+    Uint64 phaseStart = SDL_GetPerformanceCounter();
+    Uint64 phaseEnd;
+
+    // obstáculos com as posições dos canhões no fim do tick anterior
+    stepCollisionWorld(&simulation->collisionWorld);
+    phaseEnd = SDL_GetPerformanceCounter();
+    simulation->phaseTime[PHASE_COLLISION_WORLD] += phaseEnd - phaseStart;
+    traceSimulationPhase(PHASE_COLLISION_WORLD, phaseStart, phaseEnd);
+    phaseStart = phaseEnd;
+
+    runSimulationPhase(simulation, helicopterJob, simulation->numHelicopters);
+    phaseEnd = SDL_GetPerformanceCounter();
+    simulation->phaseTime[PHASE_HELICOPTERS] += phaseEnd - phaseStart;
+    traceSimulationPhase(PHASE_HELICOPTERS, phaseStart, phaseEnd);
+    phaseStart = phaseEnd;
+
+    runSimulationPhase(simulation, depotJob, simulation->depot.numProducers);
+    phaseEnd = SDL_GetPerformanceCounter();
+    simulation->phaseTime[PHASE_DEPOT] += phaseEnd - phaseStart;
+    traceSimulationPhase(PHASE_DEPOT, phaseStart, phaseEnd);
+    phaseStart = phaseEnd;
+
+    runSimulationPhase(simulation, cannonJob, simulation->numCannons);
+    phaseEnd = SDL_GetPerformanceCounter();
+    simulation->phaseTime[PHASE_CANNONS] += phaseEnd - phaseStart;
+    traceSimulationPhase(PHASE_CANNONS, phaseStart, phaseEnd);
+    phaseStart = phaseEnd;
+
+    // os helicópteros são testados contra o caminho dos mísseis no mesmo intervalo em que se
+    // moveram, antes de os mísseis que saíram da tela ou pararam nos prédios serem desativados
+    SDL_Rect buildings[2] = {simulation->scenario.rightBuilding.rect, simulation->scenario.leftBuilding.rect};
+    moveMissileSystem(&simulation->missileSystem);
+    for (int i = 0; i < simulation->numHelicopters; i++)
+        checkHelicopterMissileHit(simulation, &simulation->helicopters[i], simulation->previousHelicopterRects[i]);
+    cullMissileSystem(&simulation->missileSystem, buildings, 2);
+    phaseEnd = SDL_GetPerformanceCounter();
+    simulation->phaseTime[PHASE_MISSILES] += phaseEnd - phaseStart;
+    traceSimulationPhase(PHASE_MISSILES, phaseStart, phaseEnd);
+
+    traceEnd("tick", "simulação", tickStart);
+    simulation->tick++;
+
+    if (simulation->spectators != NULL)
+        publishSpectatorFrame(simulation->spectators, simulation);
+    if (simulation->rewind != NULL)
+        recordRewindState(simulation->rewind, simulation);
+}
+
+// Publica o estado do fim do tick pro renderizador, sem esperar por ele
+void publishSimulationSnapshot(Simulation *simulation)
+{
+    Uint64 start = traceBegin();
+    captureSimulationSnapshot(getSnapshotWriteBuffer(&simulation->snapshots), simulation);
+    publishSnapshot(&simulation->snapshots);
+    traceEnd("publica snapshot", "simulação", start);
+}
+
+// Volta a sessão REWIND_RETRY_TIME ms, pra tentar de novo o trecho que deu errado. Se o
+// helicóptero ainda estiver destruído no estado restaurado, continua voltando até antes disso.
+// Os espectadores recebem um quadro chave, já que o estado não segue do tick anterior
+static void retrySimulation(Simulation *simulation)
+{
+    int from = simulation->tick;
+    int retryTicks = REWIND_RETRY_TIME / simulation->tuning.tickTime;
+    int tick = rewindSimulation(simulation->rewind, simulation, retryTicks);
+    while (tick >= 0 && simulation->destroyed && tick > getOldestRewindTick(simulation->rewind))
+        tick = rewindSimulation(simulation->rewind, simulation, retryTicks);
+    if (tick < 0)
+        return;
+
+    if (simulation->spectators != NULL)
+        restartSpectatorStream(simulation->spectators);
+    printf("Voltando do tick %d para o tick %d\n", from, tick);
+}
+
+// Thread da simulação no modo com janela: o helicóptero 0 segue as teclas que o laço de eventos
+// coloca na fila de entrada, e os demais seguem o roteiro padrão.
+// O escalonador acorda a thread uma vez por período e diz quantos ticks venceram;
+// todas as fases avançam juntas em cada tick, e o snapshot só é publicado depois do último
+void *runSimulation(void *arg)
+{
+    Simulation *simulation = (Simulation *)arg;
+    HelicopterScript script;
+    loadHelicopterScript(&script, NULL);
+
+    setTraceThreadName("simulação", 0);
+    initTickScheduler(&simulation->scheduler, simulation->tuning.tickTime);
+    publishSimulationSnapshot(simulation);
+
+    while (simulation->running)
+    {
+        int due = waitForNextTick(&simulation->scheduler);
+
+        // cada pedido volta mais um trecho; o renderizador sabe que foi atendido quando
+        // o snapshot publicado no fim deste laço traz a contagem nova
+        Uint32 requests = __atomic_load_n(&simulation->rewindRequests, __ATOMIC_ACQUIRE);
+        while (simulation->rewindsDone != requests)
+        {
+            retrySimulation(simulation);
+            simulation->rewindsDone++;
+        }
+
+        for (int i = 0; i < due; i++)
+        {
+            // o replay em tempo real termina junto com a gravação
+            if (simulation->replay != NULL && simulation->tick >= simulation->replay->numTicks)
+            {
+                simulation->running = false;
+                break;
+            }
+
+            simulation->helicopterInputs[0] = consumeInputEvents(&simulation->input, SDL_GetPerformanceCounter());
+            fillScriptedHelicopterInputs(simulation, &script, 1);
+            stepSimulation(simulation);
+        }
+
+        publishSimulationSnapshot(simulation);
+        recordTickWork(&simulation->scheduler, due);
+    }
+
+    destroyTickScheduler(&simulation->scheduler);
+    freeHelicopterScript(&script);
+    return NULL;
+}
+
+static Uint64 hashBytes(Uint64 hash, const void *data, size_t size)
+{
+    const Uint8 *bytes = (const Uint8 *)data;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+// Resumo (FNV-1a) do estado que define o resto da sessão: canhões, helicópteros, reféns
+// e mísseis. Os mísseis entram somados, já que a posição deles nos arrays não importa
+Uint64 hashSimulationState(Simulation *simulation)
+{
+    Uint64 hash = 14695981039346656037ULL;
+
+    hash = hashBytes(hash, &simulation->tick, sizeof(simulation->tick));
+    for (int i = 0; i < simulation->numCannons; i++)
+    {
+        CannonInfo *cannon = &simulation->cannons[i];
+        hash = hashBytes(hash, &cannon->rect, sizeof(cannon->rect));
+        hash = hashBytes(hash, &cannon->speed, sizeof(cannon->speed));
+        hash = hashBytes(hash, &cannon->ammunition, sizeof(cannon->ammunition));
+        hash = hashBytes(hash, &cannon->lastShotTime, sizeof(cannon->lastShotTime));
+        hash = hashBytes(hash, &cannon->random, sizeof(cannon->random));
+    }
+    for (int i = 0; i < simulation->numHelicopters; i++)
+    {
+        HelicopterInfo *helicopter = &simulation->helicopters[i];
+        Uint8 flags = helicopter->destroyed | (helicopter->transportingHostage << 1);
+        hash = hashBytes(hash, &helicopter->rect, sizeof(helicopter->rect));
+        hash = hashBytes(hash, &flags, sizeof(flags));
+    }
+    hash = hashBytes(hash, &simulation->currentHostages, sizeof(simulation->currentHostages));
+    hash = hashBytes(hash, &simulation->rescuedHostages, sizeof(simulation->rescuedHostages));
+
+    MissileSystem *missiles = &simulation->missileSystem;
+    Uint64 missileSum = 0;
+    int activeMissiles = 0;
+    for (int i = 0; i < missiles->numMissiles; i++)
+    {
+        if (!missiles->active[i])
+            continue;
+        int fields[4] = {missiles->x[i], missiles->y[i], missiles->vx[i], missiles->vy[i]};
+        missileSum += hashBytes(14695981039346656037ULL, fields, sizeof(fields));
+        activeMissiles++;
+    }
+    hash = hashBytes(hash, &activeMissiles, sizeof(activeMissiles));
+    hash = hashBytes(hash, &missileSum, sizeof(missileSum));
+
+    return hash;
+}
+
+// Mostra o custo médio de cada fase e, se a simulação rodou com o escalonador, os atrasos
+void printSimulationStats(Simulation *simulation)
+{
+    if (simulation->tick == 0)
+        return;
+
+    double toUs = 1e6 / SDL_GetPerformanceFrequency();
+    printf("\nCusto médio por tick:");
+    for (int i = 0; i < NUM_SIMULATION_PHASES; i++)
+        printf("%s %s %.2f us", i == 0 ? "" : ",", simulationPhaseNames[i], simulation->phaseTime[i] * toUs / simulation->tick);
+    printf("\n");
+
+    printTickSchedulerStats(&simulation->scheduler);
+
+    printAmmunitionDepotStats(&simulation->depot);
+    if (simulation->numCannons > 0)
+    {
+        Uint64 ticks = 0, armedTicks = 0;
+        for (int i = 0; i < simulation->numCannons; i++)
+        {
+            ticks += simulation->cannons[i].ticks;
+            armedTicks += simulation->cannons[i].armedTicks;
+        }
+        printf("Canhões armados e fora do depósito em %.1f%% do tempo\n", ticks > 0 ? 100.0 * armedTicks / ticks : 0.0);
+    }
+
+    printBridgeStats(&simulation->bridge);
+    for (int i = 0; i < simulation->numCannons; i++)
+        printBridgeReservationStats(&simulation->cannons[i].bridgeReservation, i);
+}
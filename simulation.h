@@ -0,0 +1,138 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "cannon.h"
+#include "helicopter.h"
+#include "missile.h"
+#include "broadphase.h"
+#include "script.h"
+#include "jobs.h"
+#include "snapshot.h"
+#include "scheduler.h"
+#include "recording.h"
+#include "input.h"
+#include "bridge.h"
+#include "depot.h"
+#include "scenario.h"
+#include "spectator.h"
+#include "rewind.h"
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Fases de um tick, na ordem em que rodam
+typedef enum
+{
+    PHASE_COLLISION_WORLD,
+    PHASE_HELICOPTERS,
+    PHASE_DEPOT,
+    PHASE_CANNONS,
+    PHASE_MISSILES,
+    NUM_SIMULATION_PHASES
+} SimulationPhase;
+
+// Parâmetros de jogo de uma sessão, derivados da dificuldade e da duração do tick
+typedef struct
+{
+    int ammunition; // munição máxima de um canhão
+    int reloadTimeForEachMissile; // ms
+    int minCooldownTime; // ms
+    int maxCooldownTime; // ms
+    int tickTime; // ms
+    // velocidades em pixels por tick
+    int cannonSpeed;
+    int helicopterSpeed;
+    int missileSpeed;
+} GameTuning;
+
+// Intervalo de entidades atualizado por um job
+typedef struct
+{
+    Simulation *simulation;
+    int begin;
+    int end;
+} SimulationJob;
+
+// Uma sessão de jogo: guarda todas as entidades e todo o estado compartilhado entre elas
+// (ponte, depósito, mísseis, reféns), então várias sessões podem rodar no mesmo processo.
+// O número de canhões e helicópteros é definido na criação, e cada tick atualiza as
+// entidades em fases, com os jobs de cada fase rodando no pool
+struct Simulation
+{
+    SessionConfig config;
+    GameTuning tuning;
+
+    CannonInfo *cannons;
+    int numCannons;
+    HelicopterInfo *helicopters;
+    int numHelicopters;
+    // posições no começo do tick, usadas pra interpolar os quadros
+    SDL_Rect *previousCannonRects;
+    SDL_Rect *previousHelicopterRects;
+    // comandos de cada helicóptero no próximo tick
+    Uint8 *helicopterInputs;
+    // teclas do jogador, vindas do laço de eventos da thread principal
+    InputQueue input;
+
+    Scenario scenario;
+    CollisionWorld collisionWorld;
+    MissileSystem missileSystem;
+    Bridge bridge;
+    AmmunitionDepot depot;
+    JobPool *jobPool;
+
+    // reféns, disputados por todos os helicópteros
+    pthread_mutex_t hostagesMutex;
+    int currentHostages;
+    int rescuedHostages;
+    // algum helicóptero foi destruído
+    bool destroyed;
+
+    int tick;
+    Uint32 startTime;
+    Uint32 now;
+    volatile bool running;
+
+    // Se não forem NULL, os comandos de cada tick são gravados ou vêm de uma gravação.
+    // Nos dois casos a sessão precisa ser reproduzível, então cada fase atualiza as entidades
+    // em ordem, sem o pool, e os recursos compartilhados (reféns, ponte e depósito) são
+    // disputados sempre na mesma ordem
+    InputRecording *recorder;
+    InputRecording *replay;
+    bool deterministic;
+
+    // Se não for NULL, o estado de cada tick é transmitido aos espectadores
+    SpectatorPublisher *spectators;
+
+    // Se não for NULL, os estados dos últimos segundos ficam guardados pra voltar neles.
+    // No modo com janela, o laço de eventos soma um pedido em rewindRequests (atômico) e a
+    // thread da simulação faz uma volta pra cada pedido antes do próximo tick. rewindsDone
+    // só é mexido pela simulação e chega ao renderizador pelo snapshot
+    RewindBuffer *rewind;
+    Uint32 rewindRequests;
+    Uint32 rewindsDone;
+
+    SimulationJob *jobs;
+    int maxJobs;
+
+    // Tempo gasto em cada fase, somado em todos os ticks (em contagens do SDL_GetPerformanceCounter)
+    Uint64 phaseTime[NUM_SIMULATION_PHASES];
+
+    // Marca o ritmo dos ticks no modo com janela
+    TickScheduler scheduler;
+
+    // Estados publicados pro renderizador no modo com janela
+    SnapshotTripleBuffer snapshots;
+};
+
+bool initSimulation(Simulation *simulation, const SessionConfig *config, JobPool *jobPool);
+void destroySimulation(Simulation *simulation);
+void fillScriptedHelicopterInputs(Simulation *simulation, HelicopterScript *script, int firstHelicopter);
+void stepSimulation(Simulation *simulation);
+void publishSimulationSnapshot(Simulation *simulation);
+void *runSimulation(void *arg);
+Uint64 hashSimulationState(Simulation *simulation);
+void printSimulationStats(Simulation *simulation);
+
+#endif /* SIMULATION_H */
@@ -0,0 +1,192 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdbool.h>
+#include "snapshot.h"
+#include "simulation.h"
+
+extern int MISSILE_WIDTH;
+extern int MISSILE_HEIGHT;
+
+// Aloca os arrays do snapshot uma única vez, com espaço pra todas as entidades
+void initSimulationSnapshot(SimulationSnapshot *snapshot, int numCannons, int numHelicopters, int missileCapacity)
+{
+    snapshot->tick = -1;
+    snapshot->publishedAt = 0;
+    snapshot->tickTime = 0;
+    snapshot->maxAmmunition = 1;
+
+    snapshot->cannons = (CannonInfo *)calloc(numCannons, sizeof(CannonInfo));
+    snapshot->previousCannonRects = (SDL_Rect *)calloc(numCannons, sizeof(SDL_Rect));
+    snapshot->numCannons = numCannons;
+
+    snapshot->helicopters = (HelicopterInfo *)calloc(numHelicopters, sizeof(HelicopterInfo));
+    snapshot->previousHelicopterRects = (SDL_Rect *)calloc(numHelicopters, sizeof(SDL_Rect));
+    snapshot->numHelicopters = numHelicopters;
+
+    snapshot->missileX = (int *)malloc(sizeof(int) * missileCapacity);
+    snapshot->missileY = (int *)malloc(sizeof(int) * missileCapacity);
+    snapshot->missileVX = (int *)malloc(sizeof(int) * missileCapacity);
+    snapshot->missileVY = (int *)malloc(sizeof(int) * missileCapacity);
+    snapshot->numMissiles = 0;
+    snapshot->missileCapacity = missileCapacity;
+
+    snapshot->currentHostages = 0;
+    snapshot->rescuedHostages = 0;
+    snapshot->inputsConsumed = 0;
+    snapshot->rewindsDone = 0;
+}
+
+void destroySimulationSnapshot(SimulationSnapshot *snapshot)
+{
+    free(snapshot->cannons);
+    free(snapshot->previousCannonRects);
+    free(snapshot->helicopters);
+    free(snapshot->previousHelicopterRects);
+    free(snapshot->missileX);
+    free(snapshot->missileY);
+    free(snapshot->missileVX);
+    free(snapshot->missileVY);
+}
+
+// Copia o estado da simulação no fim do tick. Só pode ser chamada pela thread
+// que avança a simulação, entre dois ticks
+void captureSimulationSnapshot(SimulationSnapshot *snapshot, Simulation *simulation)
+{
+    snapshot->tick = simulation->tick;
+    snapshot->tickTime = simulation->tuning.tickTime;
+    snapshot->maxAmmunition = simulation->tuning.ammunition;
+
+    memcpy(snapshot->cannons, simulation->cannons, sizeof(CannonInfo) * simulation->numCannons);
+    memcpy(snapshot->previousCannonRects, simulation->previousCannonRects, sizeof(SDL_Rect) * simulation->numCannons);
+    memcpy(snapshot->helicopters, simulation->helicopters, sizeof(HelicopterInfo) * simulation->numHelicopters);
+    memcpy(snapshot->previousHelicopterRects, simulation->previousHelicopterRects, sizeof(SDL_Rect) * simulation->numHelicopters);
+
+    // só os mísseis ativos entram no snapshot
+    MissileSystem *missiles = &simulation->missileSystem;
+    int count = 0;
+    for (int i = 0; i < missiles->numMissiles && count < snapshot->missileCapacity; i++)
+    {
+        if (!missiles->active[i])
+            continue;
+
+        snapshot->missileX[count] = missiles->x[i];
+        snapshot->missileY[count] = missiles->y[i];
+        snapshot->missileVX[count] = missiles->vx[i];
+        snapshot->missileVY[count] = missiles->vy[i];
+        count++;
+    }
+    snapshot->numMissiles = count;
+
+    snapshot->currentHostages = simulation->currentHostages;
+    snapshot->rescuedHostages = simulation->rescuedHostages;
+    snapshot->inputsConsumed = getConsumedInputEvents(&simulation->input);
+    snapshot->rewindsDone = simulation->rewindsDone;
+
+    snapshot->publishedAt = SDL_GetPerformanceCounter();
+}
+
+// Fração do tick (de 0 a 1) que já passou desde que o snapshot foi publicado.
+// O quadro é desenhado um tick atrasado, indo da posição anterior até a atual
+float getSnapshotInterpolation(SimulationSnapshot *snapshot, Uint64 now)
+{
+    if (snapshot->tick < 0 || now <= snapshot->publishedAt)
+        return 0.0f;
+
+    double tickDuration = (double)SDL_GetPerformanceFrequency() * snapshot->tickTime / 1000.0;
+    double alpha = (double)(now - snapshot->publishedAt) / tickDuration;
+
+    return alpha > 1.0 ? 1.0f : (float)alpha;
+}
+
+SDL_Rect interpolateRect(SDL_Rect previous, SDL_Rect current, float alpha)
+{
+    SDL_Rect rect = current;
+    rect.x = previous.x + (int)lroundf((current.x - previous.x) * alpha);
+    rect.y = previous.y + (int)lroundf((current.y - previous.y) * alpha);
+    return rect;
+}
+
+// Desenha os mísseis do snapshot. A posição anterior de cada míssil é a atual menos
+// a velocidade, já que eles andam em linha reta com velocidade constante
+void drawSnapshotMissiles(SimulationSnapshot *snapshot, RenderBatch *batch, float alpha)
+{
+    SDL_Color red = {255, 0, 0, 255};
+
+    int back = (int)((1.0f - alpha) * MISSILE_SUBPIXEL_ONE);
+    for (int i = 0; i < snapshot->numMissiles; i++)
+    {
+        int x = snapshot->missileX[i] - ((snapshot->missileVX[i] * back) >> MISSILE_SUBPIXEL_BITS);
+        int y = snapshot->missileY[i] - ((snapshot->missileVY[i] * back) >> MISSILE_SUBPIXEL_BITS);
+
+        SDL_Rect rect = {x >> MISSILE_SUBPIXEL_BITS, y >> MISSILE_SUBPIXEL_BITS, MISSILE_WIDTH, MISSILE_HEIGHT};
+        batchFillRect(batch, &rect, red);
+    }
+}
+
+void initSnapshotTripleBuffer(SnapshotTripleBuffer *tripleBuffer, int numCannons, int numHelicopters, int missileCapacity)
+{
+    for (int i = 0; i < 3; i++)
+        initSimulationSnapshot(&tripleBuffer->buffers[i], numCannons, numHelicopters, missileCapacity);
+
+    tripleBuffer->writeIndex = 0;
+    tripleBuffer->middle = 1;
+    tripleBuffer->readIndex = 2;
+    tripleBuffer->published = 0;
+    tripleBuffer->acquired = 0;
+    tripleBuffer->reused = 0;
+}
+
+void destroySnapshotTripleBuffer(SnapshotTripleBuffer *tripleBuffer)
+{
+    for (int i = 0; i < 3; i++)
+        destroySimulationSnapshot(&tripleBuffer->buffers[i]);
+}
+
+// Buffer onde a simulação escreve o próximo snapshot. Ninguém mais lê esse buffer
+SimulationSnapshot *getSnapshotWriteBuffer(SnapshotTripleBuffer *tripleBuffer)
+{
+    return &tripleBuffer->buffers[tripleBuffer->writeIndex];
+}
+
+// Torna o buffer escrito o mais recente e passa a escrever no que estava no meio.
+// Se o renderizador não leu o anterior, ele é simplesmente descartado
+void publishSnapshot(SnapshotTripleBuffer *tripleBuffer)
+{
+    int previous = __atomic_exchange_n(&tripleBuffer->middle, tripleBuffer->writeIndex | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL);
+    tripleBuffer->writeIndex = previous & SNAPSHOT_INDEX_MASK;
+    tripleBuffer->published++;
+}
+
+// Retorna o snapshot completo mais recente. O ponteiro continua válido até a próxima chamada;
+// se não houver nada novo, é o mesmo snapshot do quadro anterior
+SimulationSnapshot *acquireLatestSnapshot(SnapshotTripleBuffer *tripleBuffer)
+{
+    if (__atomic_load_n(&tripleBuffer->middle, __ATOMIC_ACQUIRE) & SNAPSHOT_FRESH)
+    {
+        int latest = __atomic_exchange_n(&tripleBuffer->middle, tripleBuffer->readIndex, __ATOMIC_ACQ_REL);
+        tripleBuffer->readIndex = latest & SNAPSHOT_INDEX_MASK;
+        tripleBuffer->acquired++;
+    }
+    else
+    {
+        tripleBuffer->reused++;
+    }
+
+    return &tripleBuffer->buffers[tripleBuffer->readIndex];
+}
+
+void printSnapshotTripleBufferStats(SnapshotTripleBuffer *tripleBuffer)
+{
+    if (tripleBuffer->published == 0)
+        return;
+
+    Uint64 published = tripleBuffer->published;
+    printf("Snapshots: %llu publicados, %llu desenhados, %llu descartados sem ser lidos, %llu quadros repetiram o anterior\n",
+           (unsigned long long)published,
+           (unsigned long long)tripleBuffer->acquired,
+           (unsigned long long)(published - tripleBuffer->acquired),
+           (unsigned long long)tripleBuffer->reused);
+}
@@ -0,0 +1,85 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include "cannon.h"
+#include "helicopter.h"
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+typedef struct Simulation Simulation;
+
+// Cópia do estado da simulação no fim de um tick, que é tudo o que o renderizador lê.
+// Guarda também as posições do tick anterior, pra que os quadros entre dois ticks
+// possam ser desenhados interpolando entre as duas
+typedef struct
+{
+    int tick;
+    // instante (SDL_GetPerformanceCounter) em que o tick foi publicado
+    Uint64 publishedAt;
+    // duração do tick (ms) e munição máxima de um canhão na sessão
+    int tickTime;
+    int maxAmmunition;
+
+    CannonInfo *cannons;
+    SDL_Rect *previousCannonRects;
+    int numCannons;
+
+    HelicopterInfo *helicopters;
+    SDL_Rect *previousHelicopterRects;
+    int numHelicopters;
+
+    // posições e velocidades dos mísseis ativos, em sub-pixels
+    int *missileX;
+    int *missileY;
+    int *missileVX;
+    int *missileVY;
+    int numMissiles;
+    int missileCapacity;
+
+    int currentHostages;
+    int rescuedHostages;
+
+    // eventos de teclado já aplicados pela simulação, pra medir a latência até a tela
+    Uint32 inputsConsumed;
+    // pedidos de retrocesso já atendidos quando o tick foi publicado
+    Uint32 rewindsDone;
+} SimulationSnapshot;
+
+// Três snapshots trocados sem locks entre a simulação (que escreve) e o renderizador (que lê).
+// Cada lado é dono de um buffer; o terceiro fica no meio, com o último tick completo.
+// Publicar troca o buffer escrito pelo do meio, e ler troca o do meio pelo buffer lido,
+// então nenhum dos lados espera o outro e o renderizador nunca vê um tick pela metade
+#define SNAPSHOT_INDEX_MASK 3
+#define SNAPSHOT_FRESH 4
+
+typedef struct
+{
+    SimulationSnapshot buffers[3];
+    // só a simulação mexe em writeIndex, e só o renderizador em readIndex
+    int writeIndex;
+    int readIndex;
+    // índice do buffer do meio, com SNAPSHOT_FRESH se ele ainda não foi lido
+    int middle;
+
+    // Estatísticas
+    Uint64 published;
+    Uint64 acquired;
+    Uint64 reused;
+} SnapshotTripleBuffer;
+
+void initSimulationSnapshot(SimulationSnapshot *snapshot, int numCannons, int numHelicopters, int missileCapacity);
+void destroySimulationSnapshot(SimulationSnapshot *snapshot);
+void captureSimulationSnapshot(SimulationSnapshot *snapshot, Simulation *simulation);
+float getSnapshotInterpolation(SimulationSnapshot *snapshot, Uint64 now);
+SDL_Rect interpolateRect(SDL_Rect previous, SDL_Rect current, float alpha);
+void drawSnapshotMissiles(SimulationSnapshot *snapshot, RenderBatch *batch, float alpha);
+
+void initSnapshotTripleBuffer(SnapshotTripleBuffer *tripleBuffer, int numCannons, int numHelicopters, int missileCapacity);
+void destroySnapshotTripleBuffer(SnapshotTripleBuffer *tripleBuffer);
+SimulationSnapshot *getSnapshotWriteBuffer(SnapshotTripleBuffer *tripleBuffer);
+void publishSnapshot(SnapshotTripleBuffer *tripleBuffer);
+SimulationSnapshot *acquireLatestSnapshot(SnapshotTripleBuffer *tripleBuffer);
+void printSnapshotTripleBufferStats(SnapshotTripleBuffer *tripleBuffer);
+
+#endif /* SNAPSHOT_H */
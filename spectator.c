@@ -0,0 +1,852 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "spectator.h"
+#include "simulation.h"
+#include "trace.h"
+
+// Maior número de bytes que um varint de 32 bits ocupa
+#define VARINT_MAX_SIZE 5
+// Tamanho do prefixo de cada quadro no socket
+#define FRAME_HEADER_SIZE 4
+
+static Uint8 *writeVarint(Uint8 *out, Uint32 value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = (Uint8)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (Uint8)value;
+    return out;
+}
+
+// zigzag: 0, -1, 1, -2, ... viram 0, 1, 2, 3, ..., então deltas pequenos ocupam um byte
+static Uint8 *writeSignedVarint(Uint8 *out, int value)
+{
+    return writeVarint(out, ((Uint32)value << 1) ^ (Uint32)(value >> 31));
+}
+
+typedef struct
+{
+    const Uint8 *data;
+    const Uint8 *end;
+    bool failed;
+} FrameReader;
+
+static Uint32 readVarint(FrameReader *reader)
+{
+    Uint32 value = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (reader->data >= reader->end)
+            break;
+        Uint8 byte = *reader->data++;
+        value |= (Uint32)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    reader->failed = true;
+    return 0;
+}
+
+static int readSignedVarint(FrameReader *reader)
+{
+    Uint32 value = readVarint(reader);
+    return (int)(value >> 1) ^ -(int)(value & 1);
+}
+
+static Uint8 readByte(FrameReader *reader)
+{
+    if (reader->data >= reader->end)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    return *reader->data++;
+}
+
+// Lê um índice e confere se ele está dentro do array
+static int readIndex(FrameReader *reader, int count)
+{
+    Uint32 index = readVarint(reader);
+    if (count <= 0 || index >= (Uint32)count)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    return (int)index;
+}
+
+void initSpectatorState(SpectatorState *state)
+{
+    memset(state, 0, sizeof(SpectatorState));
+}
+
+void destroySpectatorState(SpectatorState *state)
+{
+    free(state->cannons);
+    free(state->helicopters);
+    free(state->missiles);
+    free(state->missileIndex);
+    free(state->missileGenerations);
+    initSpectatorState(state);
+}
+
+// Ajusta os arrays do estado pros tamanhos de um quadro chave, realocando só quando mudam
+static void resizeSpectatorState(SpectatorState *state, int numCannons, int numHelicopters, int missileSlots)
+{
+    if (numCannons != state->numCannons)
+    {
+        state->cannons = (SpectatorCannon *)realloc(state->cannons, sizeof(SpectatorCannon) * SDL_max(numCannons, 1));
+        state->numCannons = numCannons;
+    }
+    if (numHelicopters != state->numHelicopters)
+    {
+        state->helicopters = (SpectatorHelicopter *)realloc(state->helicopters, sizeof(SpectatorHelicopter) * SDL_max(numHelicopters, 1));
+        state->numHelicopters = numHelicopters;
+    }
+    if (missileSlots != state->missileSlots)
+    {
+        state->missiles = (SpectatorMissile *)realloc(state->missiles, sizeof(SpectatorMissile) * SDL_max(missileSlots, 1));
+        state->missileIndex = (int *)realloc(state->missileIndex, sizeof(int) * SDL_max(missileSlots, 1));
+        state->missileGenerations = (Uint32 *)realloc(state->missileGenerations, sizeof(Uint32) * SDL_max(missileSlots, 1));
+        state->missileSlots = missileSlots;
+    }
+
+    for (int i = 0; i < missileSlots; i++)
+        state->missileIndex[i] = -1;
+    state->numMissiles = 0;
+}
+
+static void addSpectatorMissile(SpectatorState *state, SpectatorMissile missile)
+{
+    state->missileIndex[missile.slot] = state->numMissiles;
+    state->missiles[state->numMissiles++] = missile;
+}
+
+// Tira o míssil do slot trocando pelo último da lista
+static void removeSpectatorMissile(SpectatorState *state, int slot)
+{
+    int index = state->missileIndex[slot];
+    SpectatorMissile last = state->missiles[--state->numMissiles];
+    if (last.slot != slot)
+    {
+        state->missiles[index] = last;
+        state->missileIndex[last.slot] = index;
+    }
+    state->missileIndex[slot] = -1;
+}
+
+static Uint64 hashValue(Uint64 hash, int value)
+{
+    return (hash ^ (Uint32)value) * 1099511628211ULL;
+}
+
+// Resumo do estado reconstruído, com os mísseis somados já que a ordem da lista não importa
+static Uint64 hashSpectatorState(SpectatorState *state)
+{
+    Uint64 hash = 14695981039346656037ULL;
+    for (int i = 0; i < state->numCannons; i++)
+    {
+        SpectatorCannon *cannon = &state->cannons[i];
+        hash = hashValue(hashValue(hashValue(hash, cannon->rect.x), cannon->rect.y), cannon->ammunition);
+    }
+    for (int i = 0; i < state->numHelicopters; i++)
+    {
+        SpectatorHelicopter *helicopter = &state->helicopters[i];
+        hash = hashValue(hashValue(hash, helicopter->rect.x), helicopter->rect.y);
+        hash = hashValue(hash, helicopter->transportingHostage | (helicopter->destroyed << 1));
+    }
+    hash = hashValue(hashValue(hash, state->currentHostages), state->rescuedHostages);
+
+    Uint64 missileSum = 0;
+    for (int i = 0; i < state->numMissiles; i++)
+    {
+        SpectatorMissile *missile = &state->missiles[i];
+        missileSum += hashValue(hashValue(hashValue(hashValue(hashValue(14695981039346656037ULL,
+            missile->slot), missile->x), missile->y), missile->vx), missile->vy);
+    }
+    return hashValue(hash, state->numMissiles) ^ missileSum;
+}
+
+// Quadro chave: o estado inteiro, do jeito que ficou depois do tick
+static int encodeKeyframe(SpectatorState *state, Uint8 *frame)
+{
+    Uint8 *out = frame + FRAME_HEADER_SIZE;
+    *out++ = SPECTATOR_KEYFRAME;
+    out = writeVarint(out, state->tick);
+    out = writeVarint(out, state->maxAmmunition);
+    out = writeVarint(out, state->missileSlots);
+
+    out = writeVarint(out, state->numCannons);
+    for (int i = 0; i < state->numCannons; i++)
+    {
+        SpectatorCannon *cannon = &state->cannons[i];
+        out = writeSignedVarint(out, cannon->rect.x);
+        out = writeSignedVarint(out, cannon->rect.y);
+        out = writeVarint(out, cannon->rect.w);
+        out = writeVarint(out, cannon->rect.h);
+        out = writeVarint(out, cannon->ammunition);
+    }
+
+    out = writeVarint(out, state->numHelicopters);
+    for (int i = 0; i < state->numHelicopters; i++)
+    {
+        SpectatorHelicopter *helicopter = &state->helicopters[i];
+        out = writeSignedVarint(out, helicopter->rect.x);
+        out = writeSignedVarint(out, helicopter->rect.y);
+        out = writeVarint(out, helicopter->rect.w);
+        out = writeVarint(out, helicopter->rect.h);
+        *out++ = helicopter->transportingHostage | (helicopter->destroyed << 1);
+    }
+
+    out = writeVarint(out, state->currentHostages);
+    out = writeVarint(out, state->rescuedHostages);
+
+    out = writeVarint(out, state->numMissiles);
+    for (int i = 0; i < state->numMissiles; i++)
+    {
+        SpectatorMissile *missile = &state->missiles[i];
+        out = writeVarint(out, missile->slot);
+        out = writeSignedVarint(out, missile->x);
+        out = writeSignedVarint(out, missile->y);
+        out = writeSignedVarint(out, missile->vx);
+        out = writeSignedVarint(out, missile->vy);
+    }
+
+    int size = (int)(out - frame);
+    Uint32 length = SDL_SwapLE32((Uint32)(size - FRAME_HEADER_SIZE));
+    memcpy(frame, &length, FRAME_HEADER_SIZE);
+    return size;
+}
+
+// Copia o estado inteiro da simulação pro estado anterior do publicador
+static void captureSpectatorState(SpectatorPublisher *publisher, Simulation *simulation)
+{
+    SpectatorState *state = &publisher->previous;
+    MissileSystem *missiles = &simulation->missileSystem;
+
+    state->tick = simulation->tick;
+    state->maxAmmunition = simulation->tuning.ammunition;
+    for (int i = 0; i < state->numCannons; i++)
+        state->cannons[i] = (SpectatorCannon){simulation->cannons[i].rect, simulation->cannons[i].ammunition};
+    for (int i = 0; i < state->numHelicopters; i++)
+    {
+        HelicopterInfo *helicopter = &simulation->helicopters[i];
+        state->helicopters[i] = (SpectatorHelicopter){helicopter->rect, helicopter->transportingHostage, helicopter->destroyed};
+    }
+    state->currentHostages = simulation->currentHostages;
+    state->rescuedHostages = simulation->rescuedHostages;
+
+    for (int i = 0; i < state->numMissiles; i++)
+        state->missileIndex[state->missiles[i].slot] = -1;
+    state->numMissiles = 0;
+    for (int i = 0; i < missiles->numMissiles; i++)
+    {
+        if (!missiles->active[i])
+            continue;
+
+        int slot = missiles->denseToSlot[i];
+        state->missileGenerations[slot] = missiles->generations[slot];
+        addSpectatorMissile(state, (SpectatorMissile){slot, missiles->x[i], missiles->y[i], missiles->vx[i], missiles->vy[i]});
+    }
+    state->valid = true;
+}
+
+// Quadro delta: compara a simulação com o estado anterior, atualizando-o no caminho.
+// Canhões e helicópteros só entram se mudaram, com o deslocamento em vez da posição.
+// Dos mísseis só entram os que sumiram e os que apareceram, então o custo acompanha
+// o número de mísseis vivos e o tamanho do quadro, o número de eventos
+static int encodeDelta(SpectatorPublisher *publisher, Simulation *simulation, Uint8 *frame)
+{
+    SpectatorState *state = &publisher->previous;
+    MissileSystem *missiles = &simulation->missileSystem;
+
+    Uint8 *out = frame + FRAME_HEADER_SIZE;
+    *out++ = SPECTATOR_DELTA;
+    out = writeVarint(out, simulation->tick);
+
+    // os canhões que mudaram vão pra uma área temporária no fim do buffer, porque a
+    // contagem vem antes e o tamanho dela em bytes só é conhecido no final
+    Uint8 *changes = frame + publisher->frameCapacity / 2;
+    Uint8 *changesOut = changes;
+    int changed = 0;
+    for (int i = 0; i < state->numCannons; i++)
+    {
+        SpectatorCannon *previous = &state->cannons[i];
+        CannonInfo *cannon = &simulation->cannons[i];
+        Uint8 flags = (cannon->rect.x != previous->rect.x ? SPECTATOR_CHANGED_X : 0) |
+                      (cannon->rect.y != previous->rect.y ? SPECTATOR_CHANGED_Y : 0) |
+                      (cannon->ammunition != previous->ammunition ? SPECTATOR_CHANGED_STATE : 0);
+        if (flags == 0)
+            continue;
+
+        changesOut = writeVarint(changesOut, i);
+        *changesOut++ = flags;
+        if (flags & SPECTATOR_CHANGED_X)
+            changesOut = writeSignedVarint(changesOut, cannon->rect.x - previous->rect.x);
+        if (flags & SPECTATOR_CHANGED_Y)
+            changesOut = writeSignedVarint(changesOut, cannon->rect.y - previous->rect.y);
+        if (flags & SPECTATOR_CHANGED_STATE)
+            changesOut = writeVarint(changesOut, cannon->ammunition);
+
+        *previous = (SpectatorCannon){cannon->rect, cannon->ammunition};
+        changed++;
+    }
+    out = writeVarint(out, changed);
+    memmove(out, changes, changesOut - changes);
+    out += changesOut - changes;
+
+    changesOut = changes;
+    changed = 0;
+    for (int i = 0; i < state->numHelicopters; i++)
+    {
+        SpectatorHelicopter *previous = &state->helicopters[i];
+        HelicopterInfo *helicopter = &simulation->helicopters[i];
+        Uint8 flags = (helicopter->rect.x != previous->rect.x ? SPECTATOR_CHANGED_X : 0) |
+                      (helicopter->rect.y != previous->rect.y ? SPECTATOR_CHANGED_Y : 0) |
+                      (helicopter->transportingHostage != previous->transportingHostage ||
+                       helicopter->destroyed != previous->destroyed ? SPECTATOR_CHANGED_STATE : 0);
+        if (flags == 0)
+            continue;
+
+        changesOut = writeVarint(changesOut, i);
+        *changesOut++ = flags;
+        if (flags & SPECTATOR_CHANGED_X)
+            changesOut = writeSignedVarint(changesOut, helicopter->rect.x - previous->rect.x);
+        if (flags & SPECTATOR_CHANGED_Y)
+            changesOut = writeSignedVarint(changesOut, helicopter->rect.y - previous->rect.y);
+        if (flags & SPECTATOR_CHANGED_STATE)
+            *changesOut++ = helicopter->transportingHostage | (helicopter->destroyed << 1);
+
+        *previous = (SpectatorHelicopter){helicopter->rect, helicopter->transportingHostage, helicopter->destroyed};
+        changed++;
+    }
+    out = writeVarint(out, changed);
+    memmove(out, changes, changesOut - changes);
+    out += changesOut - changes;
+
+    Uint8 hostageFlags = (simulation->currentHostages != state->currentHostages ? 1 : 0) |
+                         (simulation->rescuedHostages != state->rescuedHostages ? 2 : 0);
+    *out++ = hostageFlags;
+    if (hostageFlags & 1)
+        out = writeVarint(out, simulation->currentHostages);
+    if (hostageFlags & 2)
+        out = writeVarint(out, simulation->rescuedHostages);
+    state->currentHostages = simulation->currentHostages;
+    state->rescuedHostages = simulation->rescuedHostages;
+
+    // Mísseis: os que continuam vivos (mesmo slot e geração) só andam; o espectador faz o
+    // mesmo passo. Um slot reaproveitado neste tick conta como um que sumiu e outro que apareceu
+    Uint8 *despawns = changes;
+    Uint8 *despawnsOut = despawns;
+    int numDespawned = 0;
+    Uint8 *spawns = frame + publisher->frameCapacity * 3 / 4;
+    Uint8 *spawnsOut = spawns;
+    int numSpawned = 0;
+    int stamp = (int)publisher->ticks;
+
+    for (int i = 0; i < state->numMissiles; i++)
+    {
+        state->missiles[i].x += state->missiles[i].vx;
+        state->missiles[i].y += state->missiles[i].vy;
+    }
+
+    for (int i = 0; i < missiles->numMissiles; i++)
+    {
+        if (!missiles->active[i])
+            continue;
+
+        int slot = missiles->denseToSlot[i];
+        Uint32 generation = missiles->generations[slot];
+        publisher->missileSeen[slot] = stamp;
+
+        if (state->missileIndex[slot] >= 0)
+        {
+            if (state->missileGenerations[slot] == generation)
+                continue;
+
+            despawnsOut = writeVarint(despawnsOut, slot);
+            numDespawned++;
+            removeSpectatorMissile(state, slot);
+        }
+
+        SpectatorMissile missile = {slot, missiles->x[i], missiles->y[i], missiles->vx[i], missiles->vy[i]};
+        spawnsOut = writeVarint(spawnsOut, slot);
+        spawnsOut = writeSignedVarint(spawnsOut, missile.x);
+        spawnsOut = writeSignedVarint(spawnsOut, missile.y);
+        spawnsOut = writeSignedVarint(spawnsOut, missile.vx);
+        spawnsOut = writeSignedVarint(spawnsOut, missile.vy);
+        numSpawned++;
+
+        state->missileGenerations[slot] = generation;
+        addSpectatorMissile(state, missile);
+    }
+
+    // os que estavam na lista e não foram vistos neste tick sumiram
+    for (int i = 0; i < state->numMissiles;)
+    {
+        int slot = state->missiles[i].slot;
+        if (publisher->missileSeen[slot] == stamp)
+        {
+            i++;
+            continue;
+        }
+
+        despawnsOut = writeVarint(despawnsOut, slot);
+        numDespawned++;
+        removeSpectatorMissile(state, slot);
+    }
+
+    out = writeVarint(out, numDespawned);
+    memmove(out, despawns, despawnsOut - despawns);
+    out += despawnsOut - despawns;
+    out = writeVarint(out, numSpawned);
+    memmove(out, spawns, spawnsOut - spawns);
+    out += spawnsOut - spawns;
+
+    state->tick = simulation->tick;
+
+    int size = (int)(out - frame);
+    Uint32 length = SDL_SwapLE32((Uint32)(size - FRAME_HEADER_SIZE));
+    memcpy(frame, &length, FRAME_HEADER_SIZE);
+    return size;
+}
+
+// Cria o socket em path (apagando um que tenha sobrado de outra execução) e prepara os
+// buffers pro maior quadro possível, pra que publicar nunca aloque memória
+bool initSpectatorPublisher(SpectatorPublisher *publisher, const char *path, Simulation *simulation)
+{
+    memset(publisher, 0, sizeof(SpectatorPublisher));
+
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path))
+    {
+        printf("Caminho do socket dos espectadores longo demais: %s\n", path);
+        return false;
+    }
+    strcpy(address.sun_path, path);
+
+    publisher->listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (publisher->listenFd < 0)
+    {
+        printf("Não foi possível criar o socket dos espectadores: %s\n", strerror(errno));
+        return false;
+    }
+
+    unlink(path);
+    if (bind(publisher->listenFd, (struct sockaddr *)&address, sizeof(address)) < 0 ||
+        listen(publisher->listenFd, SPECTATOR_MAX_CLIENTS) < 0)
+    {
+        printf("Não foi possível escutar em %s: %s\n", path, strerror(errno));
+        close(publisher->listenFd);
+        return false;
+    }
+    publisher->path = strdup(path);
+
+    int missileSlots = simulation->missileSystem.numSlots;
+    initSpectatorState(&publisher->previous);
+    resizeSpectatorState(&publisher->previous, simulation->numCannons, simulation->numHelicopters, missileSlots);
+
+    // o pior caso de cada entidade em bytes, mais o mesmo espaço de novo pras áreas
+    // temporárias do delta no fim do buffer
+    int entities = 8 * VARINT_MAX_SIZE + (simulation->numCannons + simulation->numHelicopters) * (7 * VARINT_MAX_SIZE) +
+                   missileSlots * (6 * VARINT_MAX_SIZE);
+    publisher->frameCapacity = FRAME_HEADER_SIZE + 4 * entities;
+    publisher->deltaFrame = (Uint8 *)malloc(publisher->frameCapacity);
+    publisher->keyFrame = (Uint8 *)malloc(publisher->frameCapacity);
+    publisher->missileSeen = (int *)malloc(sizeof(int) * SDL_max(missileSlots, 1));
+    for (int i = 0; i < missileSlots; i++)
+        publisher->missileSeen[i] = -1;
+
+    printf("Espectadores podem se conectar em %s\n", path);
+    return true;
+}
+
+static void closeSpectatorClient(SpectatorPublisher *publisher, int index)
+{
+    SpectatorClient *client = &publisher->clients[index];
+    close(client->fd);
+    free(client->pending);
+    publisher->clients[index] = publisher->clients[--publisher->numClients];
+}
+
+void destroySpectatorPublisher(SpectatorPublisher *publisher)
+{
+    while (publisher->numClients > 0)
+        closeSpectatorClient(publisher, publisher->numClients - 1);
+
+    close(publisher->listenFd);
+    unlink(publisher->path);
+    free(publisher->path);
+    free(publisher->deltaFrame);
+    free(publisher->keyFrame);
+    free(publisher->missileSeen);
+    destroySpectatorState(&publisher->previous);
+}
+
+static void acceptSpectatorClients(SpectatorPublisher *publisher)
+{
+    while (publisher->numClients < SPECTATOR_MAX_CLIENTS)
+    {
+        int fd = accept(publisher->listenFd, NULL, NULL);
+        if (fd < 0)
+            return;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+        // cabem os dois quadros de um tick (o delta e o chave periódico)
+        SpectatorClient *client = &publisher->clients[publisher->numClients++];
+        client->fd = fd;
+        client->needsKeyframe = true;
+        client->pending = (Uint8 *)malloc(publisher->frameCapacity * 2);
+        client->pendingSize = 0;
+        client->pendingOffset = 0;
+        publisher->connections++;
+    }
+}
+
+// Tenta mandar o resto do quadro anterior. Retorna false se o espectador desconectou
+static bool flushSpectatorClient(SpectatorClient *client)
+{
+    while (client->pendingOffset < client->pendingSize)
+    {
+        ssize_t sent = send(client->fd, client->pending + client->pendingOffset,
+                            client->pendingSize - client->pendingOffset, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        client->pendingOffset += sent;
+    }
+
+    client->pendingSize = 0;
+    client->pendingOffset = 0;
+    return true;
+}
+
+// Manda um quadro sem bloquear; o que não couber no socket fica pendente pro próximo tick
+static bool sendSpectatorFrame(SpectatorPublisher *publisher, SpectatorClient *client, const Uint8 *frame, int size)
+{
+    ssize_t sent = 0;
+    if (client->pendingSize == 0)
+    {
+        sent = send(client->fd, frame, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return false;
+            sent = 0;
+        }
+    }
+
+    if (sent < size)
+    {
+        memcpy(client->pending + client->pendingSize, frame + sent, size - sent);
+        client->pendingSize += size - sent;
+    }
+    publisher->sentBytes += size;
+    return true;
+}
+
+// Chamado pela simulação no fim de cada tick, na thread dela. Sem espectadores conectados,
+// não faz nada além de aceitar conexões novas. Um espectador que ainda não esvaziou o
+// quadro anterior perde o do tick, e recebe um quadro chave quando se recuperar
+void publishSpectatorFrame(SpectatorPublisher *publisher, Simulation *simulation)
+{
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    acceptSpectatorClients(publisher);
+    if (publisher->numClients == 0)
+    {
+        publisher->previous.valid = false;
+        return;
+    }
+
+    publisher->ticks++;
+
+    Uint64 encodeStart = SDL_GetPerformanceCounter();
+    int deltaSize = 0;
+    if (publisher->previous.valid)
+    {
+        deltaSize = encodeDelta(publisher, simulation, publisher->deltaFrame);
+        publisher->deltaFrames++;
+        publisher->deltaBytes += deltaSize;
+    }
+    else
+    {
+        captureSpectatorState(publisher, simulation);
+        for (int i = 0; i < publisher->numClients; i++)
+            publisher->clients[i].needsKeyframe = true;
+    }
+
+    publisher->encodeTime += SDL_GetPerformanceCounter() - encodeStart;
+
+    // o quadro chave só é montado se alguém for recebê-lo
+    bool periodic = simulation->tick % SPECTATOR_KEYFRAME_INTERVAL == 0;
+    int keySize = 0;
+
+    for (int i = 0; i < publisher->numClients;)
+    {
+        SpectatorClient *client = &publisher->clients[i];
+        if (!flushSpectatorClient(client))
+        {
+            closeSpectatorClient(publisher, i);
+            continue;
+        }
+        if (client->pendingSize > 0)
+        {
+            publisher->droppedFrames++;
+            client->needsKeyframe = true;
+            i++;
+            continue;
+        }
+
+        bool sendKeyframe = client->needsKeyframe || periodic;
+        if (sendKeyframe && keySize == 0)
+        {
+            encodeStart = SDL_GetPerformanceCounter();
+            keySize = encodeKeyframe(&publisher->previous, publisher->keyFrame);
+            publisher->encodeTime += SDL_GetPerformanceCounter() - encodeStart;
+            publisher->keyFrames++;
+            publisher->keyBytes += keySize;
+        }
+
+        bool connected = true;
+        if (!client->needsKeyframe)
+            connected = sendSpectatorFrame(publisher, client, publisher->deltaFrame, deltaSize);
+        if (connected && sendKeyframe)
+            connected = sendSpectatorFrame(publisher, client, publisher->keyFrame, keySize);
+
+        if (!connected)
+        {
+            closeSpectatorClient(publisher, i);
+            continue;
+        }
+        client->needsKeyframe = false;
+        i++;
+    }
+
+    Uint64 end = SDL_GetPerformanceCounter();
+    publisher->totalTime += end - start;
+    if (tracingEnabled)
+        recordTraceEvent("espectadores", "simulação", start, end);
+}
+
+// O próximo tick não segue do último transmitido (a sessão voltou no tempo), então
+// todos os espectadores recebem um quadro chave
+void restartSpectatorStream(SpectatorPublisher *publisher)
+{
+    publisher->previous.valid = false;
+}
+
+void printSpectatorPublisherStats(SpectatorPublisher *publisher)
+{
+    printf("Espectadores: %llu conexões, %llu quadros delta (%.1f bytes em média), %llu quadros chave (%.1f bytes em média)\n",
+           (unsigned long long)publisher->connections,
+           (unsigned long long)publisher->deltaFrames,
+           publisher->deltaFrames > 0 ? (double)publisher->deltaBytes / publisher->deltaFrames : 0.0,
+           (unsigned long long)publisher->keyFrames,
+           publisher->keyFrames > 0 ? (double)publisher->keyBytes / publisher->keyFrames : 0.0);
+
+    if (publisher->ticks > 0)
+        printf("Espectadores: %.2f us por tick com alguém conectado (%.2f us montando os quadros), %llu bytes enviados, %llu quadros perdidos por espectadores lentos\n",
+               (double)publisher->totalTime * 1e6 / SDL_GetPerformanceFrequency() / publisher->ticks,
+               (double)publisher->encodeTime * 1e6 / SDL_GetPerformanceFrequency() / publisher->ticks,
+               (unsigned long long)publisher->sentBytes,
+               (unsigned long long)publisher->droppedFrames);
+}
+
+static bool applyKeyframe(SpectatorState *state, FrameReader *reader, int tick)
+{
+    // um quadro chave pro tick que o espectador já reconstruiu confere a reconstrução
+    bool verify = state->valid && state->tick == tick;
+    Uint64 hashBefore = verify ? hashSpectatorState(state) : 0;
+
+    // as contagens ficam sem sinal até passarem pelos limites: um valor de 2^31 ou mais
+    // viraria negativo num int e passaria pela comparação
+    int maxAmmunition = readVarint(reader);
+    Uint32 missileSlots = readVarint(reader);
+    Uint32 numCannons = readVarint(reader);
+    if (reader->failed || missileSlots > (1 << 20) || numCannons > (1 << 16))
+        return false;
+
+    // os tamanhos são conferidos contra o que resta do quadro antes de alocar
+    state->valid = false;
+    if (numCannons * 5 > reader->end - reader->data)
+        return false;
+    resizeSpectatorState(state, numCannons, state->numHelicopters, missileSlots);
+
+    for (int i = 0; i < (int)numCannons; i++)
+    {
+        SpectatorCannon *cannon = &state->cannons[i];
+        cannon->rect.x = readSignedVarint(reader);
+        cannon->rect.y = readSignedVarint(reader);
+        cannon->rect.w = readVarint(reader);
+        cannon->rect.h = readVarint(reader);
+        cannon->ammunition = readVarint(reader);
+    }
+
+    Uint32 numHelicopters = readVarint(reader);
+    if (reader->failed || numHelicopters > (1 << 16) || numHelicopters * 5 > reader->end - reader->data)
+        return false;
+    resizeSpectatorState(state, numCannons, numHelicopters, missileSlots);
+    for (int i = 0; i < (int)numHelicopters; i++)
+    {
+        SpectatorHelicopter *helicopter = &state->helicopters[i];
+        helicopter->rect.x = readSignedVarint(reader);
+        helicopter->rect.y = readSignedVarint(reader);
+        helicopter->rect.w = readVarint(reader);
+        helicopter->rect.h = readVarint(reader);
+        Uint8 flags = readByte(reader);
+        helicopter->transportingHostage = flags & 1;
+        helicopter->destroyed = (flags & 2) != 0;
+    }
+
+    state->currentHostages = readVarint(reader);
+    state->rescuedHostages = readVarint(reader);
+
+    Uint32 numMissiles = readVarint(reader);
+    if (reader->failed || numMissiles > missileSlots)
+        return false;
+    for (int i = 0; i < (int)numMissiles; i++)
+    {
+        SpectatorMissile missile;
+        missile.slot = readIndex(reader, missileSlots);
+        missile.x = readSignedVarint(reader);
+        missile.y = readSignedVarint(reader);
+        missile.vx = readSignedVarint(reader);
+        missile.vy = readSignedVarint(reader);
+        if (reader->failed || state->missileIndex[missile.slot] >= 0)
+            return false;
+        addSpectatorMissile(state, missile);
+    }
+    if (reader->failed)
+        return false;
+
+    state->maxAmmunition = maxAmmunition;
+    state->tick = tick;
+    state->valid = true;
+
+    if (verify)
+    {
+        if (hashSpectatorState(state) == hashBefore)
+            state->verifiedKeyframes++;
+        else
+            state->mismatchedKeyframes++;
+    }
+    return true;
+}
+
+static bool applyDelta(SpectatorState *state, FrameReader *reader)
+{
+    int numChanged = readVarint(reader);
+    for (int n = 0; n < numChanged && !reader->failed; n++)
+    {
+        SpectatorCannon *cannon = &state->cannons[readIndex(reader, state->numCannons)];
+        Uint8 flags = readByte(reader);
+        if (flags & SPECTATOR_CHANGED_X)
+            cannon->rect.x += readSignedVarint(reader);
+        if (flags & SPECTATOR_CHANGED_Y)
+            cannon->rect.y += readSignedVarint(reader);
+        if (flags & SPECTATOR_CHANGED_STATE)
+            cannon->ammunition = readVarint(reader);
+    }
+
+    numChanged = readVarint(reader);
+    for (int n = 0; n < numChanged && !reader->failed; n++)
+    {
+        SpectatorHelicopter *helicopter = &state->helicopters[readIndex(reader, state->numHelicopters)];
+        Uint8 flags = readByte(reader);
+        if (flags & SPECTATOR_CHANGED_X)
+            helicopter->rect.x += readSignedVarint(reader);
+        if (flags & SPECTATOR_CHANGED_Y)
+            helicopter->rect.y += readSignedVarint(reader);
+        if (flags & SPECTATOR_CHANGED_STATE)
+        {
+            Uint8 flags = readByte(reader);
+            helicopter->transportingHostage = flags & 1;
+            helicopter->destroyed = (flags & 2) != 0;
+        }
+    }
+
+    Uint8 hostageFlags = readByte(reader);
+    if (hostageFlags & 1)
+        state->currentHostages = readVarint(reader);
+    if (hostageFlags & 2)
+        state->rescuedHostages = readVarint(reader);
+
+    // os mísseis que continuam vivos dão o mesmo passo que deram na simulação
+    for (int i = 0; i < state->numMissiles; i++)
+    {
+        state->missiles[i].x += state->missiles[i].vx;
+        state->missiles[i].y += state->missiles[i].vy;
+    }
+
+    int numDespawned = readVarint(reader);
+    for (int n = 0; n < numDespawned && !reader->failed; n++)
+    {
+        int slot = readIndex(reader, state->missileSlots);
+        if (reader->failed || state->missileIndex[slot] < 0)
+            return false;
+        removeSpectatorMissile(state, slot);
+    }
+
+    int numSpawned = readVarint(reader);
+    for (int n = 0; n < numSpawned && !reader->failed; n++)
+    {
+        SpectatorMissile missile;
+        missile.slot = readIndex(reader, state->missileSlots);
+        missile.x = readSignedVarint(reader);
+        missile.y = readSignedVarint(reader);
+        missile.vx = readSignedVarint(reader);
+        missile.vy = readSignedVarint(reader);
+        if (reader->failed || state->missileIndex[missile.slot] >= 0)
+            return false;
+        addSpectatorMissile(state, missile);
+    }
+
+    return !reader->failed;
+}
+
+// Aplica um quadro (sem o prefixo de tamanho) ao estado do espectador. Deltas que não
+// continuam o tick reconstruído são ignorados até o próximo quadro chave.
+// Retorna false se o quadro estiver corrompido; o estado fica inválido até um quadro chave
+bool applySpectatorFrame(SpectatorState *state, const Uint8 *frame, int size)
+{
+    FrameReader reader = {frame, frame + size, false};
+    if (size < 1)
+        return false;
+
+    Uint8 type = *reader.data++;
+    int tick = readVarint(&reader);
+    if (reader.failed)
+        return false;
+
+    bool ok = true;
+    if (type == SPECTATOR_KEYFRAME)
+    {
+        ok = applyKeyframe(state, &reader, tick);
+    }
+    else if (type == SPECTATOR_DELTA)
+    {
+        if (!state->valid || state->tick != tick - 1)
+            return true;
+        ok = applyDelta(state, &reader);
+        state->tick = tick;
+    }
+    else
+    {
+        ok = false;
+    }
+
+    if (!ok)
+        state->valid = false;
+    return ok;
+}
@@ -0,0 +1,130 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+typedef struct Simulation Simulation;
+
+// Transmissão do estado da sessão pra espectadores locais por um socket UNIX.
+// A cada tick, a simulação compara o estado com o do tick anterior e manda só o que mudou
+// (um quadro delta); de tempos em tempos, e sempre que um espectador entra ou fica pra trás,
+// manda o estado inteiro (um quadro chave). Os mísseis andam em linha reta com velocidade
+// constante, então só são transmitidos quando aparecem e quando somem, e o espectador
+// avança as posições sozinho.
+//
+// Cada quadro vai no socket como um Uint32 com o tamanho, seguido do conteúdo. Os números
+// são varints (7 bits por byte), e os que podem ser negativos são codificados em zigzag
+
+#define SPECTATOR_KEYFRAME 1
+#define SPECTATOR_DELTA 2
+
+#define SPECTATOR_MAX_CLIENTS 8
+// Ticks entre dois quadros chave periódicos
+#define SPECTATOR_KEYFRAME_INTERVAL 100
+
+// Bits que dizem o que mudou num canhão ou helicóptero em um quadro delta
+#define SPECTATOR_CHANGED_X (1 << 0)
+#define SPECTATOR_CHANGED_Y (1 << 1)
+#define SPECTATOR_CHANGED_STATE (1 << 2)
+
+// Estado de cada entidade como é transmitido
+typedef struct
+{
+    SDL_Rect rect;
+    int ammunition;
+} SpectatorCannon;
+
+typedef struct
+{
+    SDL_Rect rect;
+    bool transportingHostage;
+    bool destroyed;
+} SpectatorHelicopter;
+
+// Posição e velocidade em sub-pixels
+typedef struct
+{
+    int slot;
+    int x;
+    int y;
+    int vx;
+    int vy;
+} SpectatorMissile;
+
+// Estado reconstruído a partir dos quadros. A simulação guarda o do tick anterior pra
+// calcular os deltas, e o espectador o atualiza com cada quadro recebido
+typedef struct
+{
+    int tick;
+    bool valid;
+    int maxAmmunition;
+
+    SpectatorCannon *cannons;
+    int numCannons;
+    SpectatorHelicopter *helicopters;
+    int numHelicopters;
+    int currentHostages;
+    int rescuedHostages;
+
+    // mísseis vivos, sem ordem; missileIndex[slot] é a posição do slot em missiles, ou -1
+    SpectatorMissile *missiles;
+    int numMissiles;
+    int *missileIndex;
+    Uint32 *missileGenerations;
+    int missileSlots;
+
+    // no espectador: quadros chave que chegaram pro tick que ele já tinha e não bateram
+    Uint64 verifiedKeyframes;
+    Uint64 mismatchedKeyframes;
+} SpectatorState;
+
+typedef struct
+{
+    int fd;
+    bool needsKeyframe;
+    // resto de um quadro que não coube no socket
+    Uint8 *pending;
+    int pendingSize;
+    int pendingOffset;
+} SpectatorClient;
+
+typedef struct
+{
+    int listenFd;
+    char *path;
+    SpectatorClient clients[SPECTATOR_MAX_CLIENTS];
+    int numClients;
+
+    SpectatorState previous;
+    Uint8 *deltaFrame;
+    Uint8 *keyFrame;
+    int frameCapacity;
+    // missileSeen[slot] é o último tick em que o slot tinha um míssil vivo
+    int *missileSeen;
+
+    // Estatísticas
+    Uint64 ticks;
+    Uint64 deltaFrames;
+    Uint64 keyFrames;
+    Uint64 deltaBytes;
+    Uint64 keyBytes;
+    Uint64 sentBytes;
+    Uint64 droppedFrames;
+    Uint64 connections;
+    Uint64 encodeTime;
+    Uint64 totalTime;
+} SpectatorPublisher;
+
+bool initSpectatorPublisher(SpectatorPublisher *publisher, const char *path, Simulation *simulation);
+void destroySpectatorPublisher(SpectatorPublisher *publisher);
+void publishSpectatorFrame(SpectatorPublisher *publisher, Simulation *simulation);
+void restartSpectatorStream(SpectatorPublisher *publisher);
+void printSpectatorPublisherStats(SpectatorPublisher *publisher);
+
+void initSpectatorState(SpectatorState *state);
+void destroySpectatorState(SpectatorState *state);
+bool applySpectatorFrame(SpectatorState *state, const Uint8 *frame, int size);
+
+#endif /* SPECTATOR_H */
@@ -0,0 +1,255 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "../assets.h"
+
+// Gera o pacote de assets do jogo: decodifica os PNGs da pasta sprites/, monta o atlas
+// e grava os pixels já decodificados junto com o índice dos quadros de cada spritesheet.
+//
+// Compilar e rodar na raiz do repositório:
+//   gcc tools/bake_assets.c `sdl2-config --cflags --libs` -lSDL2_image -lpthread -o bake_assets
+//   ./bake_assets
+
+// Espaço entre os sprites no atlas, pra evitar que a filtragem misture sprites vizinhos
+#define ATLAS_PADDING 1
+
+// Lado do bloco branco; só o centro dele é amostrado
+#define ATLAS_WHITE_SIZE 4
+
+// Formato dos pixels no pacote. É o formato nativo da maioria dos renderizadores do SDL
+// (software, OpenGL e Direct3D), então a textura é criada sem conversão
+#define ATLAS_PIXEL_FORMAT SDL_PIXELFORMAT_ARGB8888
+
+// Os pixels começam em um múltiplo disso dentro do arquivo
+#define PIXELS_ALIGNMENT 64
+
+typedef struct
+{
+    const char *path;
+    int frameWidth;
+    int frameHeight;
+} SpriteSource;
+
+// Arquivo e tamanho dos quadros de cada spritesheet. Os do cenário têm um único quadro,
+// do tamanho do spritesheet inteiro (0 = tamanho do spritesheet)
+static const SpriteSource sources[NUM_SPRITES] = {
+    [SPRITE_BACKGROUND] = {"background_spritesheet.png", 0, 0},
+    [SPRITE_LEFT_BUILDING] = {"left_building_spritesheet.png", 0, 0},
+    [SPRITE_RIGHT_BUILDING] = {"right_building_spritesheet.png", 0, 0},
+    [SPRITE_GROUND] = {"ground_spritesheet.png", 0, 0},
+    [SPRITE_BRIDGE] = {"bridge_spritesheet.png", 0, 0},
+    [SPRITE_CANNON] = {"cannon_spritesheet.png", 50, 25},
+    [SPRITE_HELICOPTER] = {"helicopter_spritesheet.png", 100, 50},
+    [SPRITE_HOSTAGE] = {"hostage_spritesheet.png", 0, 0},
+    [SPRITE_EXPLOSION] = {"explosion_spritesheet.png", 32, 32},
+};
+
+typedef struct
+{
+    char path[512];
+    SDL_Surface *image;
+    char error[256];
+} DecodeTask;
+
+// Decodifica um PNG e converte pro formato do pacote, cada um na sua thread
+static void *decodeSpritesheet(void *arg)
+{
+    DecodeTask *task = (DecodeTask *)arg;
+
+    SDL_Surface *decoded = IMG_Load(task->path);
+    if (decoded == NULL)
+    {
+        snprintf(task->error, sizeof(task->error), "%s", IMG_GetError());
+        return NULL;
+    }
+
+    task->image = SDL_ConvertSurfaceFormat(decoded, ATLAS_PIXEL_FORMAT, 0);
+    if (task->image == NULL)
+        snprintf(task->error, sizeof(task->error), "%s", SDL_GetError());
+    SDL_FreeSurface(decoded);
+
+    return NULL;
+}
+
+// Posiciona os sprites em prateleiras, do mais alto pro mais baixo.
+// Retorna a altura total ocupada no atlas
+static int packSprites(SDL_Surface *images[], AssetPackSprite sprites[], int atlasWidth)
+{
+    int order[NUM_SPRITES];
+    for (int i = 0; i < NUM_SPRITES; i++)
+        order[i] = i;
+
+    // ordena por altura decrescente (são poucos sprites, insertion sort basta)
+    for (int i = 1; i < NUM_SPRITES; i++)
+    {
+        int current = order[i];
+        int j = i - 1;
+        while (j >= 0 && images[order[j]]->h < images[current]->h)
+        {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = current;
+    }
+
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        SDL_Surface *image = images[order[i]];
+
+        // se não cabe na prateleira atual, abre uma nova embaixo
+        if (x + image->w > atlasWidth)
+        {
+            x = 0;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+
+        sprites[order[i]].x = x;
+        sprites[order[i]].y = y;
+        sprites[order[i]].w = image->w;
+        sprites[order[i]].h = image->h;
+
+        x += image->w + ATLAS_PADDING;
+        if (image->h > shelfHeight)
+            shelfHeight = image->h;
+    }
+
+    return y + shelfHeight;
+}
+
+static void freeImages(DecodeTask tasks[])
+{
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        if (tasks[i].image != NULL)
+            SDL_FreeSurface(tasks[i].image);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const char *spritesDir = argc > 1 ? argv[1] : "sprites";
+    const char *outputPath = argc > 2 ? argv[2] : ASSET_PACK_PATH;
+
+    if (SDL_Init(0) < 0 || IMG_Init(IMG_INIT_PNG) == 0)
+    {
+        printf("Não foi possível inicializar o SDL. Erro: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    DecodeTask tasks[NUM_SPRITES];
+    pthread_t threads[NUM_SPRITES];
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        snprintf(tasks[i].path, sizeof(tasks[i].path), "%s/%s", spritesDir, sources[i].path);
+        tasks[i].image = NULL;
+        tasks[i].error[0] = '\0';
+        pthread_create(&threads[i], NULL, decodeSpritesheet, &tasks[i]);
+    }
+
+    bool failed = false;
+    int atlasWidth = 1024;
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        pthread_join(threads[i], NULL);
+        if (tasks[i].image == NULL)
+        {
+            printf("Não foi possível carregar %s. Erro: %s\n", tasks[i].path, tasks[i].error);
+            failed = true;
+        }
+        else if (tasks[i].image->w > atlasWidth)
+        {
+            atlasWidth = tasks[i].image->w;
+        }
+    }
+
+    if (failed)
+    {
+        freeImages(tasks);
+        return 1;
+    }
+
+    SDL_Surface *images[NUM_SPRITES];
+    for (int i = 0; i < NUM_SPRITES; i++)
+        images[i] = tasks[i].image;
+
+    AssetPackHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.pixelFormat = ATLAS_PIXEL_FORMAT;
+    header.width = atlasWidth;
+    header.height = packSprites(images, header.sprites, atlasWidth);
+
+    // o bloco branco fica embaixo de todas as prateleiras
+    SDL_Rect whiteTexel = {0, header.height + ATLAS_PADDING, ATLAS_WHITE_SIZE, ATLAS_WHITE_SIZE};
+    header.height += ATLAS_PADDING + ATLAS_WHITE_SIZE;
+    header.whiteTexel[0] = whiteTexel.x;
+    header.whiteTexel[1] = whiteTexel.y;
+    header.whiteTexel[2] = whiteTexel.w;
+    header.whiteTexel[3] = whiteTexel.h;
+
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        header.sprites[i].frameWidth = sources[i].frameWidth > 0 ? sources[i].frameWidth : images[i]->w;
+        header.sprites[i].frameHeight = sources[i].frameHeight > 0 ? sources[i].frameHeight : images[i]->h;
+    }
+
+    SDL_Surface *atlas = SDL_CreateRGBSurfaceWithFormat(0, header.width, header.height, 32, ATLAS_PIXEL_FORMAT);
+    if (atlas == NULL)
+    {
+        printf("Não foi possível criar a superfície do atlas. Erro: %s\n", SDL_GetError());
+        freeImages(tasks);
+        return 1;
+    }
+
+    for (int i = 0; i < NUM_SPRITES; i++)
+    {
+        // copia os pixels sem mistura de alpha, preservando a transparência original
+        SDL_Rect rect = {header.sprites[i].x, header.sprites[i].y, header.sprites[i].w, header.sprites[i].h};
+        SDL_SetSurfaceBlendMode(images[i], SDL_BLENDMODE_NONE);
+        SDL_BlitSurface(images[i], NULL, atlas, &rect);
+    }
+    freeImages(tasks);
+
+    SDL_FillRect(atlas, &whiteTexel, SDL_MapRGBA(atlas->format, 255, 255, 255, 255));
+
+    header.pitch = atlas->pitch;
+    header.pixelsOffset = (sizeof(header) + PIXELS_ALIGNMENT - 1) / PIXELS_ALIGNMENT * PIXELS_ALIGNMENT;
+
+    FILE *output = fopen(outputPath, "wb");
+    if (output == NULL)
+    {
+        printf("Não foi possível criar %s\n", outputPath);
+        SDL_FreeSurface(atlas);
+        return 1;
+    }
+
+    static const Uint8 zeros[PIXELS_ALIGNMENT] = {0};
+    size_t pixelsSize = (size_t)atlas->pitch * atlas->h;
+    // sem preenchimento, o fwrite de 0 bytes retornaria 0 mesmo sem erro
+    size_t padding = header.pixelsOffset - sizeof(header);
+    bool written = fwrite(&header, sizeof(header), 1, output) == 1 &&
+                   (padding == 0 || fwrite(zeros, padding, 1, output) == 1) &&
+                   fwrite(atlas->pixels, pixelsSize, 1, output) == 1;
+    written = fclose(output) == 0 && written;
+    SDL_FreeSurface(atlas);
+
+    if (!written)
+    {
+        printf("Erro ao gravar %s\n", outputPath);
+        return 1;
+    }
+
+    printf("%s: atlas %dx%d com %d spritesheets, %zu KB\n", outputPath, header.width, header.height, NUM_SPRITES,
+           (header.pixelsOffset + pixelsSize) / 1024);
+
+    IMG_Quit();
+    SDL_Quit();
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../environment.h"
+#include "../rng.h"
+
+// Exemplo de uso da biblioteca do jogo: um agente que escolhe comandos aleatórios para
+// todos os helicópteros, lê a observação e reinicia o episódio quando ele acaba.
+// Serve também pra medir quantos passos por segundo o ambiente alcança em um núcleo.
+//
+// Compilar a biblioteca e o agente na raiz do repositório:
+//   gcc -shared -fPIC -O2 $(ls *.c | grep -v '^jogo.c$') `sdl2-config --cflags --libs` -lm -lpthread -o libjogo.so
+//   gcc tools/random_agent.c `sdl2-config --cflags --libs` -L. -ljogo -Wl,-rpath,. -o random_agent
+//   ./random_agent --steps 1000000 --cannons 4 [--shm /jogo-agente]
+
+// Quantos ticks cada comando aleatório é mantido, pra que o helicóptero chegue a algum lugar
+#define ACTION_REPEAT 20
+
+int main(int argc, char *argv[])
+{
+    int steps = 1000000;
+    const char *sharedMemoryName = NULL;
+    SessionConfig config = {1, 2, 2, 1, 6, -1, -1, 10};
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+            steps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cannons") == 0 && i + 1 < argc)
+            config.numCannons = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--helicopters") == 0 && i + 1 < argc)
+            config.numHelicopters = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc)
+            config.difficulty = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            config.seed = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc)
+            sharedMemoryName = argv[++i];
+        else
+        {
+            printf("Uso: %s [--steps N] [--cannons N] [--helicopters N] [--difficulty 1-3] [--seed N] [--shm nome]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    GameEnvironment *environment = sharedMemoryName != NULL
+                                       ? createSharedGameEnvironment(&config, 0, sharedMemoryName)
+                                       : createGameEnvironment(&config, 0, NULL, 0);
+    if (environment == NULL)
+        return 1;
+
+    RandomStream random;
+    seedRandomStream(&random, config.seed, 0);
+    Uint8 *actions = (Uint8 *)calloc(config.numHelicopters, sizeof(Uint8));
+
+    const GameObservation *observation = getGameObservation(environment);
+    Uint64 rescued = 0;
+    Uint64 start = SDL_GetPerformanceCounter();
+
+    for (int step = 0; step < steps; step++)
+    {
+        if (step % ACTION_REPEAT == 0)
+        {
+            for (int i = 0; i < config.numHelicopters; i++)
+                actions[i] = nextRandomBelow(&random, 16);
+        }
+
+        if (stepGameEnvironment(environment, actions))
+        {
+            rescued += observation->rescuedHostages;
+            resetGameEnvironment(environment, nextRandom(&random));
+        }
+    }
+
+    double seconds = (double)(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    printf("%d passos em %.3f s (%.0f passos/s, contando os resets)\n", steps, seconds, steps / seconds);
+    printf("%llu reféns resgatados no total\n", (unsigned long long)rescued);
+    printGameEnvironmentStats(environment);
+
+    free(actions);
+    destroyGameEnvironment(environment);
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../spectator.h"
+#include "../cannon.h"
+#include "../helicopter.h"
+#include "../scenario.h"
+#include "../screen.h"
+#include "../batch.h"
+#include "../missile.h"
+
+// Espectador de uma sessão transmitida com --spectate: reconstrói o estado a partir dos
+// quadros delta e chave e desenha com os mesmos sprites do jogo. Com --no-window só
+// reconstrói e mostra quantos quadros chave conferiram com a reconstrução.
+//
+// Compilar com a biblioteca do jogo (veja tools/random_agent.c) na raiz do repositório:
+//   gcc tools/spectator_viewer.c `sdl2-config --cflags --libs` -L. -ljogo -Wl,-rpath,. -o spectator_viewer
+//   ./jogo --spectate /tmp/jogo.sock &
+//   ./spectator_viewer --socket /tmp/jogo.sock [--no-window]
+
+extern int SCREEN_WIDTH;
+extern int SCREEN_HEIGHT;
+extern int NUM_HOSTAGES;
+extern int MISSILE_WIDTH;
+extern int MISSILE_HEIGHT;
+extern AssetAtlas assets;
+
+// Maior quadro aceito; um quadro chave com todos os mísseis fica bem abaixo disso
+#define MAX_FRAME_SIZE (16 << 20)
+// Intervalo entre dois quadros desenhados
+#define FRAME_TIME_MS 16
+
+typedef struct
+{
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    Scenario scenario;
+    ScenarioElementInfo *scenarioElements[5];
+    Screen screen;
+    RenderBatch batch;
+    bool batchReady;
+    // posições x do quadro desenhado antes, pra virar o helicóptero pro lado em que anda
+    int *lastHelicopterX;
+    int *helicopterMovement;
+    int numHelicopters;
+} Viewer;
+
+static bool initViewer(Viewer *viewer)
+{
+    memset(viewer, 0, sizeof(Viewer));
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        printf("Problema ao inicializar SDL. Erro: %s\n", SDL_GetError());
+        return false;
+    }
+
+    viewer->window = SDL_CreateWindow("Jogo Concorrente (espectador)", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+    if (viewer->window == NULL)
+    {
+        printf("Não foi possível abrir a janela do SDL. Erro: %s\n", SDL_GetError());
+        return false;
+    }
+
+    viewer->renderer = createScreenRenderer(viewer->window, SDL_RENDERER_ACCELERATED, false);
+    if (viewer->renderer == NULL || !loadAssets(viewer->renderer, &assets))
+        return false;
+
+    initScenario(&viewer->scenario);
+    return true;
+}
+
+// O lote e a camada fixa dependem do número de entidades, que só vem no primeiro quadro chave
+static bool prepareViewerBatch(Viewer *viewer, SpectatorState *state)
+{
+    if (viewer->batchReady)
+        return true;
+
+    int capacity = state->missileSlots + 5 + NUM_HOSTAGES + state->numCannons + state->numHelicopters;
+    if (!initRenderBatch(&viewer->batch, viewer->renderer, &assets, capacity))
+        return false;
+
+    Scenario *scenario = &viewer->scenario;
+    viewer->scenarioElements[0] = &scenario->background;
+    viewer->scenarioElements[1] = &scenario->leftBuilding;
+    viewer->scenarioElements[2] = &scenario->rightBuilding;
+    viewer->scenarioElements[3] = &scenario->ground;
+    viewer->scenarioElements[4] = &scenario->bridge;
+    initScreen(&viewer->screen, viewer->window, viewer->renderer, false, viewer->scenarioElements, 5);
+    buildStaticLayer(&viewer->screen, &viewer->batch);
+
+    viewer->numHelicopters = state->numHelicopters;
+    viewer->lastHelicopterX = (int *)calloc(state->numHelicopters, sizeof(int));
+    viewer->helicopterMovement = (int *)calloc(state->numHelicopters, sizeof(int));
+    for (int i = 0; i < state->numHelicopters; i++)
+        viewer->lastHelicopterX[i] = state->helicopters[i].rect.x;
+
+    viewer->batchReady = true;
+    return true;
+}
+
+static void drawViewer(Viewer *viewer, SpectatorState *state)
+{
+    if (!state->valid || !prepareViewerBatch(viewer, state))
+        return;
+
+    RenderBatch *batch = &viewer->batch;
+    beginScreenFrame(&viewer->screen, batch);
+
+    for (int i = 0; i < state->numCannons; i++)
+    {
+        CannonInfo cannon = {0};
+        cannon.rect = state->cannons[i].rect;
+        cannon.ammunition = state->cannons[i].ammunition;
+        drawCannon(&cannon, state->maxAmmunition, batch);
+    }
+
+    SDL_Color red = {255, 0, 0, 255};
+    for (int i = 0; i < state->numMissiles; i++)
+    {
+        SpectatorMissile *missile = &state->missiles[i];
+        SDL_Rect rect = {missile->x >> MISSILE_SUBPIXEL_BITS, missile->y >> MISSILE_SUBPIXEL_BITS, MISSILE_WIDTH, MISSILE_HEIGHT};
+        batchFillRect(batch, &rect, red);
+    }
+
+    drawHostages(batch, state->currentHostages, state->rescuedHostages);
+
+    for (int i = 0; i < state->numHelicopters && i < viewer->numHelicopters; i++)
+    {
+        SpectatorHelicopter *spectated = &state->helicopters[i];
+        int dx = spectated->rect.x - viewer->lastHelicopterX[i];
+        if (dx != 0)
+            viewer->helicopterMovement[i] = dx < 0 ? 1 : 2;
+        viewer->lastHelicopterX[i] = spectated->rect.x;
+
+        if (spectated->destroyed)
+            continue;
+
+        HelicopterInfo helicopter = {0};
+        helicopter.rect = spectated->rect;
+        helicopter.transportingHostage = spectated->transportingHostage;
+        helicopter.currentMovement = viewer->helicopterMovement[i];
+        drawHelicopter(&helicopter, batch);
+    }
+
+    endRenderBatchFrame(batch);
+    presentScreenFrame(&viewer->screen, batch);
+}
+
+static void destroyViewer(Viewer *viewer)
+{
+    if (viewer->batchReady)
+    {
+        destroyScreen(&viewer->screen);
+        destroyRenderBatch(&viewer->batch);
+        free(viewer->lastHelicopterX);
+        free(viewer->helicopterMovement);
+    }
+    destroyAssets(&assets);
+    if (viewer->renderer != NULL)
+        SDL_DestroyRenderer(viewer->renderer);
+    if (viewer->window != NULL)
+        SDL_DestroyWindow(viewer->window);
+    SDL_Quit();
+}
+
+static int connectToSession(const char *path)
+{
+    struct sockaddr_un address = {0};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0)
+    {
+        printf("Não foi possível conectar em %s: %s\n", path, strerror(errno));
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *socketPath = "/tmp/jogo.sock";
+    bool window = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (strcmp(argv[i], "--no-window") == 0)
+            window = false;
+        else
+        {
+            printf("Uso: %s [--socket caminho] [--no-window]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int fd = connectToSession(socketPath);
+    if (fd < 0)
+        return 1;
+
+    Viewer viewer;
+    if (window && !initViewer(&viewer))
+    {
+        destroyViewer(&viewer);
+        close(fd);
+        return 1;
+    }
+
+    SpectatorState state;
+    initSpectatorState(&state);
+
+    // bytes recebidos e ainda não aplicados; cada quadro é um Uint32 com o tamanho e o conteúdo
+    int capacity = 1 << 16;
+    Uint8 *buffer = (Uint8 *)malloc(capacity);
+    int size = 0;
+
+    Uint64 frames = 0;
+    Uint64 bytes = 0;
+    Uint64 corrupted = 0;
+    bool connected = true;
+    bool quit = false;
+
+    while (connected && !quit)
+    {
+        // espera dados até a hora do próximo quadro desenhado
+        struct pollfd pollFd = {fd, POLLIN, 0};
+        if (poll(&pollFd, 1, window ? FRAME_TIME_MS : -1) > 0)
+        {
+            if (size == capacity)
+            {
+                capacity *= 2;
+                buffer = (Uint8 *)realloc(buffer, capacity);
+            }
+
+            ssize_t received = recv(fd, buffer + size, capacity - size, 0);
+            if (received <= 0)
+                connected = false;
+            else
+            {
+                size += received;
+                bytes += received;
+            }
+        }
+
+        int offset = 0;
+        while (size - offset >= 4)
+        {
+            Uint32 length;
+            memcpy(&length, buffer + offset, 4);
+            length = SDL_SwapLE32(length);
+            if (length > MAX_FRAME_SIZE)
+            {
+                printf("Quadro de %u bytes, a conexão não está em sincronia\n", length);
+                connected = false;
+                break;
+            }
+
+            // o quadro ainda não chegou inteiro; o buffer cresce até caber
+            if (size - offset - 4 < (int)length)
+            {
+                while (capacity < (int)length + 4)
+                    capacity *= 2;
+                buffer = (Uint8 *)realloc(buffer, capacity);
+                break;
+            }
+
+            if (!applySpectatorFrame(&state, buffer + offset + 4, length))
+                corrupted++;
+            frames++;
+            offset += 4 + length;
+        }
+        memmove(buffer, buffer + offset, size - offset);
+        size -= offset;
+
+        if (window)
+        {
+            SDL_Event e;
+            while (SDL_PollEvent(&e) != 0)
+            {
+                if (e.type == SDL_QUIT)
+                    quit = true;
+            }
+            drawViewer(&viewer, &state);
+        }
+    }
+
+    if (!connected)
+        printf("A sessão encerrou a transmissão\n");
+    printf("%llu quadros recebidos (%llu bytes), último tick %d, %d mísseis\n",
+           (unsigned long long)frames, (unsigned long long)bytes, state.tick, state.numMissiles);
+    printf("Quadros chave conferidos com a reconstrução: %llu iguais, %llu diferentes; %llu quadros corrompidos\n",
+           (unsigned long long)state.verifiedKeyframes, (unsigned long long)state.mismatchedKeyframes,
+           (unsigned long long)corrupted);
+
+    free(buffer);
+    destroySpectatorState(&state);
+    if (window)
+        destroyViewer(&viewer);
+    close(fd);
+    return state.mismatchedKeyframes > 0 || corrupted > 0 ? 1 : 0;
+}
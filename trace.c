@@ -0,0 +1,126 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "trace.h"
+
+bool tracingEnabled = false;
+
+static const char *tracePath = NULL;
+static Uint64 traceStart = 0;
+
+// Lista de buffers de todas as threads; o lock só é usado quando uma thread registra o seu
+static pthread_mutex_t traceBuffersLock = PTHREAD_MUTEX_INITIALIZER;
+static TraceBuffer *traceBuffers = NULL;
+static int nextTraceThreadId = 1;
+
+static __thread TraceBuffer *threadTraceBuffer = NULL;
+
+// Liga o trace se um arquivo foi pedido. Precisa ser chamada antes de criar as threads
+void initTracing(const char *path)
+{
+    tracePath = path;
+    tracingEnabled = path != NULL;
+    traceStart = SDL_GetPerformanceCounter();
+}
+
+static TraceBuffer *getThreadTraceBuffer()
+{
+    if (threadTraceBuffer != NULL)
+        return threadTraceBuffer;
+
+    TraceBuffer *buffer = (TraceBuffer *)calloc(1, sizeof(TraceBuffer));
+    buffer->events = (TraceEvent *)malloc(sizeof(TraceEvent) * TRACE_EVENTS_PER_THREAD);
+    snprintf(buffer->threadName, sizeof(buffer->threadName), "thread");
+
+    pthread_mutex_lock(&traceBuffersLock);
+    buffer->threadId = nextTraceThreadId++;
+    buffer->next = traceBuffers;
+    traceBuffers = buffer;
+    pthread_mutex_unlock(&traceBuffersLock);
+
+    threadTraceBuffer = buffer;
+    return buffer;
+}
+
+// Dá um nome à thread atual no trace, como "worker 2"
+void setTraceThreadName(const char *format, int index)
+{
+    if (!tracingEnabled)
+        return;
+
+    TraceBuffer *buffer = getThreadTraceBuffer();
+    snprintf(buffer->threadName, sizeof(buffer->threadName), format, index);
+}
+
+void recordTraceEvent(const char *name, const char *category, Uint64 start, Uint64 end)
+{
+    TraceBuffer *buffer = getThreadTraceBuffer();
+
+    TraceEvent *event = &buffer->events[buffer->count % TRACE_EVENTS_PER_THREAD];
+    event->name = name;
+    event->category = category;
+    event->start = start;
+    event->duration = end - start;
+    buffer->count++;
+}
+
+// Grava todos os eventos no formato JSON do trace do Chrome, que também abre no Perfetto.
+// Só pode ser chamada depois que as threads que gravam eventos terminaram
+void writeTrace()
+{
+    if (!tracingEnabled)
+        return;
+
+    FILE *file = fopen(tracePath, "w");
+    if (file == NULL)
+    {
+        printf("Não foi possível criar o arquivo de trace %s\n", tracePath);
+        return;
+    }
+
+    double toUs = 1e6 / SDL_GetPerformanceFrequency();
+    Uint64 written = 0, dropped = 0;
+    bool first = true;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    pthread_mutex_lock(&traceBuffersLock);
+    for (TraceBuffer *buffer = traceBuffers; buffer != NULL; buffer = buffer->next)
+    {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", buffer->threadId, buffer->threadName);
+        first = false;
+
+        // com o anel cheio, os eventos mais antigos foram sobrescritos
+        Uint64 begin = buffer->count > TRACE_EVENTS_PER_THREAD ? buffer->count - TRACE_EVENTS_PER_THREAD : 0;
+        dropped += begin;
+
+        for (Uint64 i = begin; i < buffer->count; i++)
+        {
+            TraceEvent *event = &buffer->events[i % TRACE_EVENTS_PER_THREAD];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event->name, event->category, buffer->threadId,
+                    (event->start - traceStart) * toUs, event->duration * toUs);
+            written++;
+        }
+    }
+
+    // as threads já terminaram, então os buffers podem ser liberados
+    while (traceBuffers != NULL)
+    {
+        TraceBuffer *next = traceBuffers->next;
+        free(traceBuffers->events);
+        free(traceBuffers);
+        traceBuffers = next;
+    }
+    threadTraceBuffer = NULL;
+    tracingEnabled = false;
+    pthread_mutex_unlock(&traceBuffersLock);
+
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    printf("\nTrace: %llu eventos gravados em %s (%llu sobrescritos)\n", (unsigned long long)written, tracePath, (unsigned long long)dropped);
+}
@@ -0,0 +1,52 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Eventos guardados por thread. Quando o buffer enche, os mais antigos são sobrescritos
+#define TRACE_EVENTS_PER_THREAD 65536
+
+// Um intervalo de tempo medido ("complete event" do formato de trace do Chrome)
+typedef struct
+{
+    const char *name;
+    const char *category;
+    Uint64 start;
+    Uint64 duration;
+} TraceEvent;
+
+// Anel de eventos de uma thread. Só a própria thread escreve; o arquivo é gerado
+// no fim, depois que as outras threads terminaram
+typedef struct TraceBuffer
+{
+    TraceEvent *events;
+    Uint64 count;
+    int threadId;
+    char threadName[32];
+    struct TraceBuffer *next;
+} TraceBuffer;
+
+// Lido a cada evento. Com o trace desligado, medir um intervalo custa só esse teste
+extern bool tracingEnabled;
+
+void initTracing(const char *path);
+void setTraceThreadName(const char *format, int index);
+void recordTraceEvent(const char *name, const char *category, Uint64 start, Uint64 end);
+void writeTrace();
+
+// Marca o começo de um intervalo. Retorna 0 com o trace desligado
+static inline Uint64 traceBegin()
+{
+    return tracingEnabled ? SDL_GetPerformanceCounter() : 0;
+}
+
+// Fecha o intervalo aberto por traceBegin
+static inline void traceEnd(const char *name, const char *category, Uint64 start)
+{
+    if (start != 0)
+        recordTraceEvent(name, category, start, SDL_GetPerformanceCounter());
+}
+
+#endif /* TRACE_H */